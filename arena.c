@@ -0,0 +1,84 @@
+#include "arena.h"
+#include <stdlib.h>
+
+#define ARENA_MAX_ALIGN 64
+
+// Block header; padded to ARENA_MAX_ALIGN so the data after it is aligned for
+// any request
+struct ArenaBlock {
+    _Alignas(ARENA_MAX_ALIGN) struct ArenaBlock* next;
+    size_t size;                 // usable bytes after the header
+};
+
+static unsigned char* block_data(struct ArenaBlock* block) {
+    return (unsigned char*)(block + 1);
+}
+
+void arena_init(struct Arena* arena, size_t block_size) {
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+    arena->block_size = block_size;
+    arena->blocks = 0;
+    arena->resets = 0;
+}
+
+// New block after the current one; blocks further along stay in the chain
+static struct ArenaBlock* arena_add_block(struct Arena* arena, size_t size) {
+    size_t block_size = arena->block_size ? arena->block_size : ARENA_DEFAULT_BLOCK;
+    if (size > block_size) block_size = size;
+    block_size = (block_size + ARENA_MAX_ALIGN - 1) & ~(size_t)(ARENA_MAX_ALIGN - 1);
+
+    struct ArenaBlock* block = aligned_alloc(ARENA_MAX_ALIGN, sizeof(*block) + block_size);
+    if (!block) return NULL;
+    arena->blocks++;
+    block->size = block_size;
+    if (arena->current) {
+        block->next = arena->current->next;
+        arena->current->next = block;
+    } else {
+        block->next = arena->first;
+        arena->first = block;
+    }
+    return block;
+}
+
+void* arena_alloc(struct Arena* arena, size_t size, size_t align) {
+    if (align == 0) align = 1;
+    if (arena->current) {
+        size_t offset = (arena->used + align - 1) & ~(align - 1);
+        if (offset <= arena->current->size && size <= arena->current->size - offset) {
+            arena->used = offset + size;
+            return block_data(arena->current) + offset;
+        }
+    }
+
+    // Move on to the next block kept from an earlier game, or a new one when
+    // that is too small (block data starts aligned, so offset 0 fits any align)
+    struct ArenaBlock* next = arena->current ? arena->current->next : arena->first;
+    if (!next || next->size < size) {
+        next = arena_add_block(arena, size);
+        if (!next) return NULL;
+    }
+    arena->current = next;
+    arena->used = size;
+    return block_data(next);
+}
+
+void arena_reset(struct Arena* arena) {
+    arena->current = arena->first;
+    arena->used = 0;
+    arena->resets++;
+}
+
+void arena_free(struct Arena* arena) {
+    struct ArenaBlock* block = arena->first;
+    while (block) {
+        struct ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->used = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Bump allocator for memory that lives exactly as long as one game (or one
+// batch worker). Allocation carves the next aligned piece out of the current
+// block; arena_reset rewinds to the first block in O(1) without returning
+// anything to malloc, so once a worker has played its largest game every later
+// game allocates from blocks it already owns. Blocks are only released by
+// arena_free.
+// A zero-initialised Arena is valid and empty, with the default block size.
+
+#define ARENA_DEFAULT_BLOCK (64 * 1024)
+
+struct ArenaBlock;
+
+struct Arena {
+    struct ArenaBlock* first;
+    struct ArenaBlock* current;  // block allocations are carved from
+    size_t used;                 // bytes taken from the current block
+    size_t block_size;           // usable size of a new block, 0 = ARENA_DEFAULT_BLOCK
+    long blocks;                 // malloc calls made so far (one per block)
+    long resets;
+};
+
+/**
+ * @brief Set up an empty arena; nothing is allocated until the first request.
+ * @param[out] arena Arena to initialise.
+ * @param[in] block_size Usable bytes per block, 0 = ARENA_DEFAULT_BLOCK.
+ */
+void arena_init(struct Arena* arena, size_t block_size);
+
+/**
+ * @brief Allocate size bytes aligned to align (a power of two, at most 64).
+ *        Requests larger than a block get a block of their own.
+ * @param[in,out] arena Arena to allocate from.
+ * @param[in] size Bytes wanted.
+ * @param[in] align Alignment wanted.
+ * @return Uninitialised memory valid until the next reset, or NULL when out of memory.
+ */
+void* arena_alloc(struct Arena* arena, size_t size, size_t align);
+
+/**
+ * @brief Forget every allocation in O(1); the blocks are kept for reuse.
+ * @param[in,out] arena Arena to rewind.
+ */
+void arena_reset(struct Arena* arena);
+
+/**
+ * @brief Release every block. The arena is empty and reusable afterwards.
+ * @param[in,out] arena Arena to release.
+ */
+void arena_free(struct Arena* arena);
+
+#endif // ARENA_H
@@ -0,0 +1,1594 @@
+#include "bench.h"
+#include "runner.h"
+#include "helpers.h"
+#include "map.h"
+#include "roomstack.h"
+#include "sim.h"
+#include "pool.h"
+#include "hunterrules.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdatomic.h>
+
+struct Benchmark {
+    const char* name;
+    const char* description;
+    bool (*run)(void);
+};
+
+static double bench_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// ---- Entity count scaling ----
+// Plays virtual-clock games with growing hunter and ghost counts on one worker
+// and reports entity ticks executed per second.
+static bool bench_entities(void) {
+    static const int hunter_counts[] = { 4, 16, 64, 256, 1024 };
+    static const int ghost_counts[] = { 1, 4 };
+    const long target_ticks = 2000000; // roughly constant work per step
+
+    printf("%8s %7s %7s %12s %14s %14s\n", "hunters", "ghosts", "runs", "ticks/run", "ticks/sec", "runs/sec");
+    for (size_t g = 0; g < sizeof(ghost_counts) / sizeof(ghost_counts[0]); g++) {
+        for (size_t h = 0; h < sizeof(hunter_counts) / sizeof(hunter_counts[0]); h++) {
+            int hunter_count = hunter_counts[h];
+            struct Hunter* roster = calloc((size_t)hunter_count, sizeof(*roster));
+            if (!roster) return false;
+            for (int i = 0; i < hunter_count; i++) {
+                roster[i].id = i + 1;
+                snprintf(roster[i].name, sizeof(roster[i].name), "Hunter %d", i + 1);
+            }
+
+            // Game length grows with entity count; about 30 ticks per hunter per game
+            long runs = target_ticks / (30L * hunter_count);
+            if (runs < 4) runs = 4;
+            struct RunnerConfig config = {
+                .workers = 1,
+                .runs = runs,
+                .seed = 1,
+                .first_run = 0,
+                .engine = SIM_ENGINE_EVENTS,
+                .roster = roster,
+                .hunter_count = hunter_count,
+                .ghost_count = ghost_counts[g],
+                .room_capacity = 0
+            };
+
+            struct BatchStats stats;
+            double seconds = 0.0;
+            bool ok = runner_run(&config, &stats, &seconds);
+            free(roster);
+            if (!ok) return false;
+
+            printf("%8d %7d %7ld %12.0f %14.0f %14.1f\n",
+                   hunter_count, ghost_counts[g], stats.runs,
+                   (double)stats.total_ticks / (double)stats.runs,
+                   seconds > 0 ? (double)stats.total_ticks / seconds : 0.0,
+                   seconds > 0 ? (double)stats.runs / seconds : 0.0);
+        }
+    }
+    return true;
+}
+
+// ---- House maps ----
+// Generates houses of growing size and times saving them, loading them back in
+// both formats and building a House on top of the loaded layout.
+static bool bench_maps(void) {
+    static const uint32_t room_counts[] = { 10000, 100000, 1000000 };
+    const int loads = 20;
+    char bin_path[64];
+    char text_path[64];
+    snprintf(bin_path, sizeof(bin_path), "/tmp/ghostbusters-bench-%d.map", (int)getpid());
+    snprintf(text_path, sizeof(text_path), "/tmp/ghostbusters-bench-%d.txt", (int)getpid());
+
+    printf("%9s %6s %10s %10s %12s %12s %11s %12s\n",
+           "rooms", "index", "gen(ms)", "bin(KiB)", "load bin(ms)", "load txt(ms)", "house(ms)", "bytes/room");
+    bool ok = true;
+    for (size_t r = 0; ok && r < sizeof(room_counts) / sizeof(room_counts[0]); r++) {
+        struct HouseMap generated;
+        double started = bench_seconds();
+        if (!map_generate(&generated, room_counts[r], 1)) return false;
+        double gen_ms = (bench_seconds() - started) * 1000.0;
+        ok = map_save_binary(&generated, bin_path) && map_save_text(&generated, text_path);
+
+        // Binary loads are mmap plus one validation pass; average several
+        double bin_ms = 0.0;
+        for (int i = 0; ok && i < loads; i++) {
+            struct HouseMap loaded;
+            started = bench_seconds();
+            ok = map_load(&loaded, bin_path);
+            bin_ms += (bench_seconds() - started) * 1000.0;
+            if (ok) ok = loaded.room_count == generated.room_count && loaded.adj_count == generated.adj_count;
+            map_free(&loaded);
+        }
+        bin_ms /= loads;
+
+        struct HouseMap parsed;
+        started = bench_seconds();
+        ok = ok && map_load(&parsed, text_path);
+        double text_ms = (bench_seconds() - started) * 1000.0;
+        if (ok) ok = parsed.adj_count == generated.adj_count;
+        map_free(&parsed);
+
+        struct House house;
+        started = bench_seconds();
+        ok = ok && house_init(&house, &generated);
+        double house_ms = (bench_seconds() - started) * 1000.0;
+        if (ok) house_cleanup(&house);
+
+        if (ok) {
+            printf("%9u %4s%2d %10.2f %10.0f %12.3f %12.2f %11.2f %12.1f\n",
+                   generated.room_count, "u", generated.adj16 ? 16 : 32, gen_ms,
+                   (double)generated.image_size / 1024.0, bin_ms, text_ms, house_ms,
+                   (double)generated.image_size / generated.room_count);
+        }
+        map_free(&generated);
+    }
+    unlink(bin_path);
+    unlink(text_path);
+    return ok;
+}
+
+// ---- Return-to-van routing ----
+// Plays the same games with returning hunters wandering (the old behaviour) and
+// following the precomputed exit routes, and compares how long returns take.
+static bool bench_routing(void) {
+    static const uint32_t room_counts[] = { 0, 1000, 10000 }; // 0 = Willow
+    const int hunter_count = 4;
+    struct Hunter roster[4];
+    memset(roster, 0, sizeof(roster));
+    for (int i = 0; i < hunter_count; i++) {
+        roster[i].id = i + 1;
+        snprintf(roster[i].name, sizeof(roster[i].name), "Hunter %d", i + 1);
+    }
+
+    printf("%8s %8s %7s %10s %14s %10s %11s %7s\n",
+           "rooms", "return", "runs", "arrived", "moves/arrival", "abandoned", "ticks/run", "win%");
+    for (size_t r = 0; r < sizeof(room_counts) / sizeof(room_counts[0]); r++) {
+        struct HouseMap generated;
+        memset(&generated, 0, sizeof(generated));
+        if (room_counts[r] && !map_generate(&generated, room_counts[r], 1)) return false;
+        const struct HouseMap* map = room_counts[r] ? &generated : map_willow();
+
+        for (int random_return = 1; random_return >= 0; random_return--) {
+            struct RunnerConfig config = {
+                .workers = 1,
+                .runs = room_counts[r] ? 2000 : 20000,
+                .seed = 1,
+                .first_run = 0,
+                .engine = SIM_ENGINE_EVENTS,
+                .roster = roster,
+                .hunter_count = hunter_count,
+                .ghost_count = 1,
+                .room_capacity = MAX_ROOM_OCCUPANCY,
+                .map = room_counts[r] ? map : NULL,
+                .random_return = random_return != 0
+            };
+            struct BatchStats stats;
+            double seconds = 0.0;
+            if (!runner_run(&config, &stats, &seconds)) {
+                map_free(&generated);
+                return false;
+            }
+
+            long trips = stats.van_trips + stats.van_trips_abandoned;
+            printf("%8u %8s %7ld %10ld %14.2f %9.1f%% %11.1f %6.1f%%\n",
+                   map->room_count, random_return ? "wander" : "route", stats.runs, stats.van_trips,
+                   stats.van_trips ? (double)stats.van_trip_ticks / stats.van_trips : 0.0,
+                   trips ? 100.0 * stats.van_trips_abandoned / trips : 0.0,
+                   (double)stats.total_ticks / stats.runs,
+                   100.0 * stats.wins / stats.runs);
+        }
+        map_free(&generated);
+    }
+    return true;
+}
+
+// ---- Breadcrumb stack ----
+// The linked-list RoomStack this tree used before, kept as the baseline: one
+// malloc per push and one free per pop.
+struct ListNode {
+    struct Room* room;
+    struct ListNode* next;
+};
+
+static bool list_push(struct ListNode** top, struct Room* room) {
+    struct ListNode* node = malloc(sizeof(*node));
+    if (!node) return false;
+    node->room = room;
+    node->next = *top;
+    *top = node;
+    return true;
+}
+
+static struct Room* list_pop(struct ListNode** top) {
+    if (!*top) return NULL;
+    struct ListNode* node = *top;
+    struct Room* room = node->room;
+    *top = node->next;
+    free(node);
+    return room;
+}
+
+static void list_clear(struct ListNode** top) {
+    while (list_pop(top));
+}
+
+// Workloads: a hunter-like trail (push a few rooms, clear at the van), steady
+// push/pop churn, and one deep push-then-pop-all sweep
+enum StackPattern { PATTERN_TRAIL, PATTERN_CHURN, PATTERN_DEEP };
+
+static double run_list(enum StackPattern pattern, long ops, struct Room* room) {
+    struct ListNode* top = NULL;
+    double started = bench_seconds();
+    for (long done = 0; done < ops; ) {
+        if (pattern == PATTERN_TRAIL) {
+            for (int i = 0; i < 24; i++) list_push(&top, room);
+            list_clear(&top);
+            done += 48;
+        } else if (pattern == PATTERN_CHURN) {
+            list_push(&top, room);
+            list_pop(&top);
+            done += 2;
+        } else {
+            for (long i = 0; i < ops / 2; i++) list_push(&top, room);
+            list_clear(&top);
+            done = ops;
+        }
+    }
+    return bench_seconds() - started;
+}
+
+static double run_array(enum StackPattern pattern, long ops, struct Room* room, int limit) {
+    struct RoomStack stack;
+    stack_init(&stack);
+    stack_set_limit(&stack, limit);
+    double started = bench_seconds();
+    for (long done = 0; done < ops; ) {
+        if (pattern == PATTERN_TRAIL) {
+            for (int i = 0; i < 24; i++) stack_push(&stack, room);
+            // pop the trail back like list_clear does, so both pay per element
+            while (stack_pop(&stack));
+            done += 48;
+        } else if (pattern == PATTERN_CHURN) {
+            stack_push(&stack, room);
+            stack_pop(&stack);
+            done += 2;
+        } else {
+            for (long i = 0; i < ops / 2; i++) stack_push(&stack, room);
+            while (stack_pop(&stack));
+            done = ops;
+        }
+    }
+    double seconds = bench_seconds() - started;
+    stack_free(&stack);
+    return seconds;
+}
+
+static bool bench_stack(void) {
+    static const char* const names[] = { "trail", "churn", "deep" };
+    const long ops = 20000000;
+    struct Room* room = (struct Room*)&ops; // never dereferenced
+
+    printf("%8s %14s %14s %14s %9s\n", "pattern", "list Mops/s", "array Mops/s", "ring Mops/s", "speedup");
+    for (int p = PATTERN_TRAIL; p <= PATTERN_DEEP; p++) {
+        double list = run_list((enum StackPattern)p, ops, room);
+        double array = run_array((enum StackPattern)p, ops, room, 0);
+        double ring = run_array((enum StackPattern)p, ops, room, HUNTER_BREADCRUMB_DEPTH);
+        printf("%8s %14.1f %14.1f %14.1f %8.1fx\n", names[p],
+               ops / list / 1e6, ops / array / 1e6, ops / ring / 1e6, list / array);
+    }
+    printf("(ring = depth %d, as hunters use; deep pushes past it overwrite the oldest rooms)\n",
+           HUNTER_BREADCRUMB_DEPTH);
+    return true;
+}
+
+// ---- Evidence contention ----
+// Many hunter threads and one ghost thread hammer a single room's evidence:
+// each hunter checks the room (R-17) and tries to claim its device's bit (R-20)
+// while the ghost keeps depositing. Compares the old mutex-guarded byte with
+// the atomic fetch-or / fetch-and version and checks no bit is claimed twice.
+struct EvidenceArena {
+    bool use_atomic;
+    struct Room room;             // atomic version
+    pthread_mutex_t lock;         // mutex version
+    EvidenceByte locked_bits;
+    long iterations;              // per hunter
+    atomic_bool stop;
+    atomic_long placed;           // bits the ghost added that were not already there
+    atomic_long claimed;          // bits hunters took
+    pthread_barrier_t start;
+};
+
+struct EvidenceWorker {
+    struct EvidenceArena* arena;
+    int index;
+    pthread_t thread;
+    double began;                 // own timestamps: with few cores the main thread
+    double ended;                 // may not run until the hunters are done
+};
+
+static void* evidence_hunter_fn(void* arg) {
+    struct EvidenceWorker* worker = arg;
+    struct EvidenceArena* arena = worker->arena;
+    EvidenceByte device = (EvidenceByte)(1 << (worker->index % 7));
+    long claimed = 0;
+    long fear = 0;
+
+    pthread_barrier_wait(&arena->start);
+    worker->began = bench_seconds();
+    for (long i = 0; i < arena->iterations; i++) {
+        if (arena->use_atomic) {
+            if (room_evidence(&arena->room)) fear++;
+            if (room_claim_evidence(&arena->room, device)) claimed++;
+        } else {
+            pthread_mutex_lock(&arena->lock);
+            if (arena->locked_bits) fear++;
+            pthread_mutex_unlock(&arena->lock);
+            pthread_mutex_lock(&arena->lock);
+            if (arena->locked_bits & device) {
+                arena->locked_bits &= (EvidenceByte)~device;
+                claimed++;
+            }
+            pthread_mutex_unlock(&arena->lock);
+        }
+    }
+    worker->ended = bench_seconds();
+    atomic_fetch_add(&arena->claimed, claimed);
+    return (void*)(intptr_t)(fear & 1); // keep the reads observable
+}
+
+static void* evidence_ghost_fn(void* arg) {
+    struct EvidenceArena* arena = arg;
+    struct Rng rng;
+    rng_seed(&rng, 1, RNG_STREAM_GHOST(DEFAULT_GHOST_ID));
+    long placed = 0;
+
+    pthread_barrier_wait(&arena->start);
+    while (!atomic_load_explicit(&arena->stop, memory_order_relaxed)) {
+        EvidenceByte bit = (EvidenceByte)(1 << rng_below(&rng, 7));
+        if (arena->use_atomic) {
+            if (room_place_evidence(&arena->room, bit)) placed++;
+        } else {
+            pthread_mutex_lock(&arena->lock);
+            if (!(arena->locked_bits & bit)) placed++;
+            arena->locked_bits |= bit;
+            pthread_mutex_unlock(&arena->lock);
+        }
+    }
+    atomic_fetch_add(&arena->placed, placed);
+    return NULL;
+}
+
+// One measurement; returns hunter operations per second or -1 on failure
+static double evidence_round(bool use_atomic, int hunter_count, long total_ops, bool* consistent) {
+    struct EvidenceArena arena;
+    memset(&arena, 0, sizeof(arena));
+    arena.use_atomic = use_atomic;
+    arena.iterations = total_ops / 2 / hunter_count;
+    room_init(&arena.room, "Contention Room", false);
+    pthread_mutex_init(&arena.lock, NULL);
+    atomic_init(&arena.stop, false);
+    atomic_init(&arena.placed, 0);
+    atomic_init(&arena.claimed, 0);
+    pthread_barrier_init(&arena.start, NULL, (unsigned)hunter_count + 2);
+
+    struct EvidenceWorker* workers = calloc((size_t)hunter_count, sizeof(*workers));
+    pthread_t ghost;
+    int started = 0;
+    bool ok = workers && pthread_create(&ghost, NULL, evidence_ghost_fn, &arena) == 0;
+    bool ghost_started = ok;
+    for (int i = 0; ok && i < hunter_count; i++) {
+        workers[i].arena = &arena;
+        workers[i].index = i;
+        ok = pthread_create(&workers[i].thread, NULL, evidence_hunter_fn, &workers[i]) == 0;
+        if (ok) started++;
+    }
+    if (!ok) {
+        // Not everyone reached the barrier; nothing sensible to measure
+        fprintf(stderr, "Failed to start contention threads\n");
+        exit(1);
+    }
+
+    pthread_barrier_wait(&arena.start);
+    double begin = 0.0;
+    double end = 0.0;
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (i == 0 || workers[i].began < begin) begin = workers[i].began;
+        if (workers[i].ended > end) end = workers[i].ended;
+    }
+    double seconds = end - begin;
+    atomic_store(&arena.stop, true);
+    if (ghost_started) pthread_join(ghost, NULL);
+
+    EvidenceByte left = use_atomic ? room_evidence(&arena.room) : arena.locked_bits;
+    *consistent = atomic_load(&arena.placed) == atomic_load(&arena.claimed) + __builtin_popcount(left);
+
+    pthread_barrier_destroy(&arena.start);
+    pthread_mutex_destroy(&arena.lock);
+    pthread_mutex_destroy(&arena.room.mutex);
+    free(workers);
+    long ops = arena.iterations * 2L * hunter_count;
+    return seconds > 0 ? ops / seconds : 0.0;
+}
+
+static bool bench_evidence(void) {
+    static const int hunter_counts[] = { 4, 64, 512 };
+    const long total_ops = 8000000;
+
+    printf("%8s %14s %14s %9s %12s\n", "hunters", "mutex Mops/s", "atomic Mops/s", "speedup", "exactly-once");
+    for (size_t i = 0; i < sizeof(hunter_counts) / sizeof(hunter_counts[0]); i++) {
+        bool mutex_ok = false;
+        bool atomic_ok = false;
+        double locked = evidence_round(false, hunter_counts[i], total_ops, &mutex_ok);
+        double lock_free = evidence_round(true, hunter_counts[i], total_ops, &atomic_ok);
+        printf("%8d %14.1f %14.1f %8.2fx %12s\n", hunter_counts[i], locked / 1e6, lock_free / 1e6,
+               locked > 0 ? lock_free / locked : 0.0, mutex_ok && atomic_ok ? "yes" : "NO");
+        if (!mutex_ok || !atomic_ok) return false;
+    }
+    return true;
+}
+
+// ---- Two-room transfer stress ----
+// Every thread is one hunter walking the Willow house at random as fast as it
+// can, while a ghost-like thread polls room presence. Runs the old move
+// protocol (leave under one lock, join under another, re-join on a full room)
+// and room_transfer_hunter, then checks every hunter is listed exactly once,
+// in its own room, and no room is over capacity.
+struct TransferArena {
+    struct House house;
+    struct Hunter* hunters;
+    bool use_transfer;
+    long moves;                   // per hunter
+    atomic_long lock_ops;
+    atomic_bool stop;
+    pthread_barrier_t start;
+};
+
+struct TransferWorker {
+    struct TransferArena* arena;
+    struct Hunter* hunter;
+    pthread_t thread;
+    double began;
+    double ended;
+};
+
+// The move sequence hunter_tick used before room_transfer_hunter
+static long legacy_move(struct Room* old, struct Room* next, struct Hunter* h) {
+    pthread_mutex_lock(&old->mutex);
+    room_remove_hunter(old, h);
+    pthread_mutex_unlock(&old->mutex);
+    h->current_room = next;
+    pthread_mutex_lock(&next->mutex);
+    bool entered = room_add_hunter(next, h);
+    pthread_mutex_unlock(&next->mutex);
+    if (!entered) {
+        h->current_room = old;
+        pthread_mutex_lock(&old->mutex);
+        room_add_hunter(old, h);
+        pthread_mutex_unlock(&old->mutex);
+        return 3;
+    }
+    return 2;
+}
+
+static void* transfer_hunter_fn(void* arg) {
+    struct TransferWorker* worker = arg;
+    struct TransferArena* arena = worker->arena;
+    struct Hunter* h = worker->hunter;
+    long lock_ops = 0;
+
+    pthread_barrier_wait(&arena->start);
+    worker->began = bench_seconds();
+    for (long i = 0; i < arena->moves; i++) {
+        struct Room* old = h->current_room;
+        struct Room* next = room_neighbor(old, rng_range(&h->rng, 0, old->conn_count));
+        if (arena->use_transfer) {
+            if (room_transfer_hunter(old, next, h)) h->current_room = next;
+            lock_ops += 2;
+        } else {
+            lock_ops += legacy_move(old, next, h);
+        }
+    }
+    worker->ended = bench_seconds();
+    atomic_fetch_add(&arena->lock_ops, lock_ops);
+    return NULL;
+}
+
+static void* transfer_ghost_fn(void* arg) {
+    struct TransferArena* arena = arg;
+    long seen = 0;
+    pthread_barrier_wait(&arena->start);
+    while (!atomic_load_explicit(&arena->stop, memory_order_relaxed)) {
+        for (int r = 0; r < arena->house.room_count; r++) {
+            seen += room_has_hunters(&arena->house.rooms[r]);
+        }
+    }
+    return (void*)(intptr_t)(seen & 1);
+}
+
+// Hunters not listed exactly once in their own room, plus rooms over capacity
+static int transfer_violations(struct TransferArena* arena, int hunter_count) {
+    int violations = 0;
+    int listed = 0;
+    for (int r = 0; r < arena->house.room_count; r++) {
+        struct Room* room = &arena->house.rooms[r];
+        int count = room_occupancy(room);
+        if (room->occupancy_limit > 0 && count > room->occupancy_limit) violations++;
+        for (int i = 0; i < count; i++) {
+            struct Hunter* h = room->occupants[i];
+            if (h->current_room == room && h->room_slot == i) listed++;
+        }
+    }
+    return violations + (hunter_count - listed);
+}
+
+// One stress round; returns moves per second and the invariant violations found
+static double transfer_round(bool use_transfer, int hunter_count, long total_moves, double* locks_per_move,
+                             int* violations) {
+    struct TransferArena arena;
+    memset(&arena, 0, sizeof(arena));
+    if (!house_init(&arena.house, NULL)) return -1.0;
+    arena.use_transfer = use_transfer;
+    arena.moves = total_moves / hunter_count;
+    atomic_init(&arena.lock_ops, 0);
+    atomic_init(&arena.stop, false);
+    pthread_barrier_init(&arena.start, NULL, (unsigned)hunter_count + 2);
+
+    // Spread the hunters over the rooms without exceeding the capacity
+    arena.hunters = calloc((size_t)hunter_count, sizeof(*arena.hunters));
+    struct TransferWorker* workers = calloc((size_t)hunter_count, sizeof(*workers));
+    if (!arena.hunters || !workers) exit(1);
+    for (int i = 0; i < hunter_count; i++) {
+        struct Hunter* h = &arena.hunters[i];
+        h->id = i + 1;
+        h->room_slot = -1;
+        rng_seed(&h->rng, 7, RNG_STREAM_HUNTER(h->id));
+        for (int r = i % arena.house.room_count; ; r = (r + 1) % arena.house.room_count) {
+            if (room_add_hunter(&arena.house.rooms[r], h)) {
+                h->current_room = &arena.house.rooms[r];
+                break;
+            }
+        }
+    }
+
+    pthread_t ghost;
+    if (pthread_create(&ghost, NULL, transfer_ghost_fn, &arena) != 0) exit(1);
+    for (int i = 0; i < hunter_count; i++) {
+        workers[i].arena = &arena;
+        workers[i].hunter = &arena.hunters[i];
+        if (pthread_create(&workers[i].thread, NULL, transfer_hunter_fn, &workers[i]) != 0) {
+            fprintf(stderr, "Failed to start stress threads\n");
+            exit(1);
+        }
+    }
+    pthread_barrier_wait(&arena.start);
+
+    double begin = 0.0;
+    double end = 0.0;
+    for (int i = 0; i < hunter_count; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (i == 0 || workers[i].began < begin) begin = workers[i].began;
+        if (workers[i].ended > end) end = workers[i].ended;
+    }
+    atomic_store(&arena.stop, true);
+    pthread_join(ghost, NULL);
+
+    *violations = transfer_violations(&arena, hunter_count);
+    long moves = arena.moves * hunter_count;
+    *locks_per_move = (double)atomic_load(&arena.lock_ops) / moves;
+
+    pthread_barrier_destroy(&arena.start);
+    house_cleanup(&arena.house);
+    free(arena.hunters);
+    free(workers);
+    return end > begin ? moves / (end - begin) : 0.0;
+}
+
+static bool bench_transfer(void) {
+    static const int hunter_counts[] = { 8, 64, 100 }; // Willow holds 13 rooms x 8 hunters
+    const long total_moves = 4000000;
+
+    printf("%8s %16s %11s %10s %16s %11s %10s\n", "hunters", "legacy moves/s", "locks/move", "lost",
+           "transfer moves/s", "locks/move", "lost");
+    bool ok = true;
+    for (size_t i = 0; i < sizeof(hunter_counts) / sizeof(hunter_counts[0]); i++) {
+        double legacy_locks = 0.0;
+        double transfer_locks = 0.0;
+        int legacy_lost = 0;
+        int transfer_lost = 0;
+        double legacy = transfer_round(false, hunter_counts[i], total_moves, &legacy_locks, &legacy_lost);
+        double transfer = transfer_round(true, hunter_counts[i], total_moves, &transfer_locks, &transfer_lost);
+        if (legacy < 0 || transfer < 0) return false;
+        printf("%8d %16.0f %11.2f %10d %16.0f %11.2f %10d\n", hunter_counts[i],
+               legacy, legacy_locks, legacy_lost, transfer, transfer_locks, transfer_lost);
+        ok = ok && transfer_lost == 0;
+    }
+    // The legacy protocol can lose a hunter: while it is in no room, another
+    // hunter may take the last place in the room it has to fall back to
+    printf("room_transfer_hunter kept every hunter listed: %s\n", ok ? "yes" : "NO");
+    return ok;
+}
+
+// ---- Evidence deduction ----
+// Answers the three questions a report or hunter asks about a mask (is it a
+// ghost, are three types found, which ghosts still fit) by scanning, as the
+// helpers did before, and through the deduction table.
+static uint32_t deduce_by_scan(EvidenceByte mask) {
+    const enum GhostType* ghost_types = NULL;
+    int ghost_count = get_all_ghost_types(&ghost_types);
+    uint32_t candidates = 0;
+    bool valid = false;
+    for (int i = 0; i < ghost_count; i++) {
+        if ((mask & (EvidenceByte)ghost_types[i]) == mask) candidates |= 1u << i;
+        if (mask == (EvidenceByte)ghost_types[i]) valid = true;
+    }
+    int bits = 0;
+    for (int i = 0; i < 7; i++) {
+        if (mask & (1 << i)) bits++;
+    }
+    return candidates ^ (uint32_t)valid ^ (uint32_t)(bits >= 3);
+}
+
+static uint32_t deduce_by_table(EvidenceByte mask) {
+    const struct EvidenceDeduction* deduction = evidence_deduce(mask);
+    return deduction->candidates ^ (uint32_t)deduction->identifies ^ (uint32_t)(deduction->evidence_count >= 3);
+}
+
+static bool bench_deduce(void) {
+    const long queries = 50000000;
+    struct Rng rng;
+    EvidenceByte masks[1024];
+    rng_seed(&rng, 1, RNG_STREAM_SETUP);
+    for (int i = 0; i < 1024; i++) masks[i] = (EvidenceByte)rng_below(&rng, EVIDENCE_MASK_COUNT);
+
+    volatile uint32_t sink = 0;
+    uint32_t scan_sum = 0;
+    double started = bench_seconds();
+    for (long i = 0; i < queries; i++) scan_sum += deduce_by_scan(masks[i & 1023]);
+    double scan = bench_seconds() - started;
+
+    uint32_t table_sum = 0;
+    started = bench_seconds();
+    for (long i = 0; i < queries; i++) table_sum += deduce_by_table(masks[i & 1023]);
+    double table = bench_seconds() - started;
+    sink = scan_sum ^ table_sum;
+    (void)sink;
+
+    printf("%8s %14s %12s\n", "method", "Mqueries/s", "ns/query");
+    printf("%8s %14.1f %12.2f\n", "scan", queries / scan / 1e6, scan * 1e9 / queries);
+    printf("%8s %14.1f %12.2f\n", "table", queries / table / 1e6, table * 1e9 / queries);
+    printf("Answers identical: %s\n", scan_sum == table_sum ? "yes" : "NO");
+    return scan_sum == table_sum;
+}
+
+// ---- Shared case file ----
+// Private evidence is the old game: each hunter needs all three pieces itself.
+// Shared, any hunter's find goes on the case file and the game ends for
+// everyone once the ghost is identified.
+static bool bench_casefile(void) {
+    static const int hunter_counts[] = { 4, 16 };
+    struct Hunter roster[16];
+    memset(roster, 0, sizeof(roster));
+    for (int i = 0; i < 16; i++) {
+        roster[i].id = i + 1;
+        snprintf(roster[i].name, sizeof(roster[i].name), "Hunter %d", i + 1);
+    }
+
+    printf("%7s %8s %7s %7s %9s %11s %11s %11s\n",
+           "hunters", "evidence", "runs", "win%", "solved%", "length(s)", "won len(s)", "ticks/run");
+    for (size_t n = 0; n < sizeof(hunter_counts) / sizeof(hunter_counts[0]); n++) {
+        double length[2] = { 0.0, 0.0 };
+        for (int private_evidence = 1; private_evidence >= 0; private_evidence--) {
+            struct RunnerConfig config = {
+                .workers = 1,
+                .runs = 20000,
+                .seed = 1,
+                .first_run = 0,
+                .engine = SIM_ENGINE_EVENTS,
+                .roster = roster,
+                .hunter_count = hunter_counts[n],
+                .ghost_count = 1,
+                .room_capacity = MAX_ROOM_OCCUPANCY,
+                .private_evidence = private_evidence != 0
+            };
+            struct BatchStats stats;
+            double seconds = 0.0;
+            if (!runner_run(&config, &stats, &seconds)) return false;
+
+            long long won_ms = 0;
+            for (int g = 0; g < GHOST_TYPE_COUNT; g++) won_ms += stats.by_ghost[g].solve_ms_total;
+            length[private_evidence] = (double)stats.total_duration_ms / stats.runs / 1000.0;
+            printf("%7d %8s %7ld %6.1f%% %8.1f%% %11.2f %11.2f %11.1f\n",
+                   hunter_counts[n], private_evidence ? "private" : "shared", stats.runs,
+                   100.0 * stats.wins / stats.runs, 100.0 * stats.cases_solved / stats.runs,
+                   length[private_evidence], stats.wins ? (double)won_ms / stats.wins / 1000.0 : 0.0,
+                   (double)stats.total_ticks / stats.runs);
+        }
+        printf("%7s mean game length %.1f%% shorter with the shared case file\n", "",
+               length[1] > 0.0 ? 100.0 * (length[1] - length[0]) / length[1] : 0.0);
+    }
+    return true;
+}
+
+// ---- Ghost teardown ----
+// Time from clearing the ghosts' running flags to the last join. The legacy
+// loop sleeps with usleep and only notices the flag on its next tick.
+static void* legacy_ghost_fn(void* arg) {
+    struct Ghost* g = arg;
+    ghost_start(g);
+    while (ghost_tick(g)) {
+        usleep(GHOST_TICK_MS * 1000);
+    }
+    return NULL;
+}
+
+// One batch of stop-and-join measurements; false when threads cannot start
+static bool teardown_round(bool legacy, int trials, double* mean_us, double* max_us) {
+    enum { GHOSTS = 4 };
+    struct House house;
+    if (!house_init(&house, NULL)) return false;
+    struct Ghost ghosts[GHOSTS];
+    memset(ghosts, 0, sizeof(ghosts));
+    struct Rng rng;
+    rng_seed(&rng, 1, RNG_STREAM_SETUP);
+
+    bool ok = true;
+    double total = 0.0;
+    *max_us = 0.0;
+    for (int t = 0; ok && t < trials; t++) {
+        sim_setup_ghosts(&house, ghosts, GHOSTS, sim_run_seed(1, (uint64_t)t));
+        int started = 0;
+        for (int i = 0; i < GHOSTS; i++) {
+            if (pthread_create(&ghosts[i].thread, NULL, legacy ? legacy_ghost_fn : ghost_thread_fn, &ghosts[i]) != 0) break;
+            started++;
+        }
+        ok = started == GHOSTS;
+
+        // Stop at a random point of the ghosts' tick
+        usleep((useconds_t)rng_range(&rng, 1, GHOST_TICK_MS) * 1000);
+        double began = bench_seconds();
+        for (int i = 0; i < started; i++) {
+            atomic_store(&ghosts[i].running, false);
+        }
+        if (!legacy) simclock_wake_all(&house.waker);
+        for (int i = 0; i < started; i++) {
+            pthread_join(ghosts[i].thread, NULL);
+        }
+        double us = (bench_seconds() - began) * 1e6;
+        total += us;
+        if (us > *max_us) *max_us = us;
+        house_reset(&house);
+    }
+    house_cleanup(&house);
+    *mean_us = total / trials;
+    return ok;
+}
+
+static bool bench_teardown(void) {
+    const int trials = 20;
+    printf("%8s %7s %12s %12s\n", "sleep", "trials", "mean(us)", "max(us)");
+    for (int legacy = 1; legacy >= 0; legacy--) {
+        double mean_us = 0.0;
+        double max_us = 0.0;
+        if (!teardown_round(legacy != 0, trials, &mean_us, &max_us)) {
+            fprintf(stderr, "Failed to start ghost threads\n");
+            return false;
+        }
+        printf("%8s %7d %12.0f %12.0f\n", legacy ? "usleep" : "waker", trials, mean_us, max_us);
+    }
+    return true;
+}
+
+// ---- Wakeup latency ----
+// One watcher thread paced like a hunter sits in a room; the main thread drops
+// evidence at a random point of its tick and times how long the watcher takes
+// to claim it, with fixed pacing and with reactive room signals.
+struct WakeupArena {
+    struct House house;
+    struct Room* room;
+    atomic_bool running;
+    _Atomic double claimed_at;    // bench_seconds() when the watcher took the evidence
+};
+
+static void* wakeup_watcher_fn(void* arg) {
+    struct WakeupArena* arena = arg;
+    struct Room* room = arena->room;
+    struct TickSchedule schedule;
+    simclock_schedule_start(&schedule, HUNTER_TICK_MS);
+    while (atomic_load(&arena->running)) {
+        unsigned seen = room_signal_seen(room, ROOM_SIGNAL_EVIDENCE);
+        if (room_claim_evidence(room, EV_EMF)) {
+            atomic_store(&arena->claimed_at, bench_seconds());
+        }
+        struct timespec deadline;
+        simclock_schedule_next(&schedule, &deadline);
+        if (arena->house.reactive) {
+            room_wait_signal(room, ROOM_SIGNAL_EVIDENCE, seen, &deadline, &arena->running);
+        } else {
+            simclock_sleep_until(&arena->house.waker, &deadline, &arena->running);
+        }
+    }
+    return NULL;
+}
+
+static bool wakeup_round(bool reactive, int trials, double* mean_us, double* max_us) {
+    struct WakeupArena arena;
+    memset(&arena, 0, sizeof(arena));
+    if (!house_init(&arena.house, NULL)) return false;
+    arena.house.reactive = reactive;
+    arena.room = arena.house.starting_room;
+    atomic_init(&arena.running, true);
+    atomic_init(&arena.claimed_at, 0.0);
+    struct Rng rng;
+    rng_seed(&rng, 1, RNG_STREAM_SETUP);
+
+    pthread_t watcher;
+    if (pthread_create(&watcher, NULL, wakeup_watcher_fn, &arena) != 0) {
+        house_cleanup(&arena.house);
+        return false;
+    }
+
+    double total = 0.0;
+    *max_us = 0.0;
+    for (int t = 0; t < trials; t++) {
+        usleep((useconds_t)rng_range(&rng, 1, HUNTER_TICK_MS) * 1000);
+        atomic_store(&arena.claimed_at, 0.0);
+        double placed = bench_seconds();
+        room_place_evidence(arena.room, EV_EMF);
+        while (atomic_load(&arena.claimed_at) == 0.0) {
+            usleep(50);
+        }
+        double us = (atomic_load(&arena.claimed_at) - placed) * 1e6;
+        total += us;
+        if (us > *max_us) *max_us = us;
+    }
+
+    atomic_store(&arena.running, false);
+    house_wake_all(&arena.house);
+    pthread_join(watcher, NULL);
+    house_cleanup(&arena.house);
+    *mean_us = total / trials;
+    return true;
+}
+
+static bool bench_wakeup(void) {
+    const int trials = 30;
+    printf("%9s %7s %12s %12s\n", "mode", "trials", "mean(us)", "max(us)");
+    for (int reactive = 0; reactive <= 1; reactive++) {
+        double mean_us = 0.0;
+        double max_us = 0.0;
+        if (!wakeup_round(reactive != 0, trials, &mean_us, &max_us)) {
+            fprintf(stderr, "Failed to start the watcher thread\n");
+            return false;
+        }
+        printf("%9s %7d %12.0f %12.0f\n", reactive ? "reactive" : "pacing", trials, mean_us, max_us);
+    }
+    return true;
+}
+
+// ---- Tick cadence ----
+// Entity-like threads tick every CADENCE_PERIOD_MS, doing up to 20 ms of work
+// per tick with an 80 ms stall every tenth tick (a slow log flush). The old
+// loop sleeps a relative period after the work; the schedule sleeps to
+// absolute deadlines. Reports the real period, the ticks skipped after
+// overruns, and how far the last tick drifted from the phase of its ideal
+// start once skipped ticks are accounted for.
+#define CADENCE_PERIOD_MS 50
+#define CADENCE_TICKS 100
+#define CADENCE_THREADS 4
+
+struct CadenceWorker {
+    bool absolute;
+    int index;
+    pthread_t thread;
+    struct SimWaker waker;
+    atomic_bool running;
+    struct TickSchedule schedule;
+    double drift_ms;              // last tick start minus its ideal start
+    double max_period_ms;
+};
+
+static void* cadence_fn(void* arg) {
+    struct CadenceWorker* worker = arg;
+    struct Rng rng;
+    rng_seed(&rng, 1, RNG_STREAM_HUNTER(worker->index));
+    simclock_schedule_start(&worker->schedule, CADENCE_PERIOD_MS);
+
+    double first = bench_seconds();
+    double previous = first;
+    for (int tick = 0; tick < CADENCE_TICKS; tick++) {
+        double now = bench_seconds();
+        if (tick > 0 && (now - previous) * 1000.0 > worker->max_period_ms) worker->max_period_ms = (now - previous) * 1000.0;
+        previous = now;
+        if (tick + 1 == CADENCE_TICKS) {
+            worker->drift_ms = (now - first) * 1000.0 - (double)tick * CADENCE_PERIOD_MS;
+            break;
+        }
+
+        long work_ms = rng_range(&rng, 0, 21) + (tick % 10 == 9 ? 80 : 0);
+        usleep((useconds_t)work_ms * 1000);
+
+        if (worker->absolute) {
+            struct timespec deadline;
+            simclock_schedule_next(&worker->schedule, &deadline);
+            simclock_sleep_until(&worker->waker, &deadline, &worker->running);
+        } else {
+            usleep(CADENCE_PERIOD_MS * 1000);
+        }
+    }
+    return NULL;
+}
+
+static bool bench_cadence(void) {
+    printf("%9s %9s %13s %13s %9s %8s %12s\n", "sleep", "ticks", "mean period", "max period", "overruns", "skipped",
+           "phase drift");
+    for (int absolute = 0; absolute <= 1; absolute++) {
+        struct CadenceWorker workers[CADENCE_THREADS];
+        memset(workers, 0, sizeof(workers));
+        int started = 0;
+        for (int i = 0; i < CADENCE_THREADS; i++) {
+            workers[i].absolute = absolute != 0;
+            workers[i].index = i;
+            atomic_init(&workers[i].running, true);
+            if (!simclock_waker_init(&workers[i].waker)) break;
+            if (pthread_create(&workers[i].thread, NULL, cadence_fn, &workers[i]) != 0) {
+                simclock_waker_destroy(&workers[i].waker);
+                break;
+            }
+            started++;
+        }
+
+        double drift = 0.0;
+        double max_period = 0.0;
+        long overruns = 0;
+        long missed = 0;
+        for (int i = 0; i < started; i++) {
+            pthread_join(workers[i].thread, NULL);
+            simclock_waker_destroy(&workers[i].waker);
+            drift += workers[i].drift_ms / started;
+            if (workers[i].max_period_ms > max_period) max_period = workers[i].max_period_ms;
+            overruns += workers[i].schedule.overruns;
+            missed += workers[i].schedule.missed;
+        }
+        if (started < CADENCE_THREADS) {
+            fprintf(stderr, "Failed to start cadence threads\n");
+            return false;
+        }
+        double mean_period = CADENCE_PERIOD_MS + drift / (CADENCE_TICKS - 1);
+        double phase_drift = drift - (double)missed / started * CADENCE_PERIOD_MS;
+        printf("%9s %9d %10.1f ms %10.1f ms %9ld %8ld %9.1f ms\n", absolute ? "deadline" : "usleep",
+               CADENCE_TICKS, mean_period, max_period, overruns, missed, phase_drift);
+    }
+    return true;
+}
+
+// ---- Worker pool scale ----
+// One real-time Willow game with unlimited rooms and growing hunter counts on
+// the pool engine. Memory per entity is the resident-set growth from
+// allocating the hunters to the end of the game, divided by the entities.
+// A thread per entity would reserve a whole default stack on top of that.
+#define POOL_BENCH_WORKERS 4
+static long bench_resident_bytes(void) {
+    long size = 0;
+    long resident = 0;
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) return 0;
+    if (fscanf(statm, "%ld %ld", &size, &resident) != 2) resident = 0;
+    fclose(statm);
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+static bool bench_pool(void) {
+    static const int hunter_counts[] = { 1000, 10000, 100000 };
+    size_t stack_size = 0;
+    pthread_attr_t attr;
+    if (pthread_attr_init(&attr) == 0) {
+        pthread_attr_getstacksize(&attr, &stack_size);
+        pthread_attr_destroy(&attr);
+    }
+    printf("struct Hunter %zu bytes, breadcrumb ring up to %zu bytes, default thread stack %zu KiB\n",
+           sizeof(struct Hunter), (size_t)HUNTER_BREADCRUMB_DEPTH * sizeof(struct Room*), stack_size / 1024);
+
+    printf("%8s %8s %9s %10s %11s %9s %9s %12s\n",
+           "hunters", "workers", "length(s)", "ticks", "ticks/sec", "overrun%", "steals", "bytes/entity");
+    for (size_t n = 0; n < sizeof(hunter_counts) / sizeof(hunter_counts[0]); n++) {
+        int hunter_count = hunter_counts[n];
+        struct House house;
+        if (!house_init(&house, NULL)) return false;
+        house_set_room_capacity(&house, 0);
+
+        long resident_before = bench_resident_bytes();
+        struct Hunter* hunters = calloc((size_t)hunter_count, sizeof(*hunters));
+        if (!hunters) {
+            house_cleanup(&house);
+            return false;
+        }
+        struct Ghost ghost;
+        memset(&ghost, 0, sizeof(ghost));
+        uint64_t run_seed = sim_run_seed(1, 0);
+        sim_setup_ghosts(&house, &ghost, 1, run_seed);
+        for (int i = 0; i < hunter_count; i++) {
+            hunters[i].id = i + 1;
+            snprintf(hunters[i].name, sizeof(hunters[i].name), "Hunter %d", i + 1);
+            sim_setup_hunter(&house, &hunters[i], run_seed);
+        }
+
+        struct PoolReport report;
+        bool ok = pool_run(&house, &ghost, 1, hunters, hunter_count, POOL_BENCH_WORKERS, &report);
+        long resident_after = bench_resident_bytes();
+
+        long deadlines = ghost.schedule.deadlines;
+        long overruns = ghost.schedule.overruns;
+        for (int i = 0; i < hunter_count; i++) {
+            deadlines += hunters[i].schedule.deadlines;
+            overruns += hunters[i].schedule.overruns;
+            stack_free(&hunters[i].breadcrumb);
+        }
+        free(hunters);
+        house_cleanup(&house);
+        if (!ok) return false;
+
+        double seconds = report.duration_ms / 1000.0;
+        printf("%8d %8d %9.2f %10ld %11.0f %8.2f%% %9ld %12.0f\n",
+               hunter_count, report.workers, seconds, report.ticks,
+               seconds > 0 ? report.ticks / seconds : 0.0,
+               deadlines ? 100.0 * overruns / deadlines : 0.0, report.steals,
+               (double)(resident_after - resident_before) / (hunter_count + 1));
+    }
+    return true;
+}
+
+// ---- Hunter layout ----
+// The R-17 stat update and R-19 check for every hunter of a Willow house,
+// round after round, with fresh room evidence each round. The AoS pass walks
+// struct Hunter the way hunter_tick does; the SoA pass runs the hunter store's
+// phase loops. Hunters that leave respawn with zeroed counters so the load
+// stays constant. Both passes must end with the same counters, and the store
+// written back must give the AoS hunters.
+
+// Data-oriented hunter state: the two phases only need a hunter's room,
+// counters, evidence and device, so the store keeps each of those in its own
+// contiguous array and runs the phases as straight loops over every hunter,
+// which the compiler turns into SIMD code (gcc needs -O3, or -O2
+// -fvect-cost-model=dynamic).
+struct HunterStore {
+    int count;
+    int capacity;
+    uint32_t* room;           // index into house->rooms
+    int32_t* boredom;
+    int32_t* fear;
+    EvidenceByte* collected;
+    EvidenceByte* device;
+    EvidenceByte* seen;       // room evidence gathered for the current tick
+    int8_t* verdict;          // R-19 result: LR_BORED, LR_AFRAID or HUNTER_STAYS
+};
+
+static void hunter_store_free(struct HunterStore* store) {
+    free(store->room);
+    free(store->boredom);
+    free(store->fear);
+    free(store->collected);
+    free(store->device);
+    free(store->seen);
+    free(store->verdict);
+    store->room = NULL;
+    store->boredom = NULL;
+    store->fear = NULL;
+    store->collected = NULL;
+    store->device = NULL;
+    store->seen = NULL;
+    store->verdict = NULL;
+    store->count = 0;
+    store->capacity = 0;
+}
+
+static bool hunter_store_init(struct HunterStore* store, int capacity) {
+    size_t n = capacity > 0 ? (size_t)capacity : 1;
+    store->count = 0;
+    store->capacity = capacity;
+    store->room = malloc(n * sizeof(*store->room));
+    store->boredom = malloc(n * sizeof(*store->boredom));
+    store->fear = malloc(n * sizeof(*store->fear));
+    store->collected = malloc(n * sizeof(*store->collected));
+    store->device = malloc(n * sizeof(*store->device));
+    store->seen = malloc(n * sizeof(*store->seen));
+    store->verdict = malloc(n * sizeof(*store->verdict));
+    if (!store->room || !store->boredom || !store->fear || !store->collected || !store->device || !store->seen ||
+        !store->verdict) {
+        hunter_store_free(store);
+        return false;
+    }
+    return true;
+}
+
+static int hunter_store_load(struct HunterStore* store, const struct House* house, const struct Hunter* hunter) {
+    if (store->count >= store->capacity) return -1;
+    int slot = store->count++;
+    store->room[slot] = (uint32_t)(hunter->current_room - house->rooms);
+    store->boredom[slot] = hunter->boredom;
+    store->fear[slot] = hunter->fear;
+    store->collected[slot] = hunter->collected;
+    store->device[slot] = (EvidenceByte)hunter->current_device;
+    store->seen[slot] = 0;
+    store->verdict[slot] = HUNTER_STAYS;
+    return slot;
+}
+
+static void hunter_store_save(const struct HunterStore* store, int slot, struct House* house, struct Hunter* hunter) {
+    hunter->current_room = &house->rooms[store->room[slot]];
+    hunter->boredom = store->boredom[slot];
+    hunter->fear = store->fear[slot];
+    hunter->collected = store->collected[slot];
+    hunter->current_device = (enum EvidenceType)store->device[slot];
+}
+
+// Gathering is the one indexed load per hunter; the two phases after it only
+// touch their own arrays and vectorise.
+static void hunter_store_gather(struct HunterStore* store, struct House* house) {
+    const uint32_t* restrict room = store->room;
+    EvidenceByte* restrict seen = store->seen;
+    struct Room* rooms = house->rooms;
+    int count = store->count;
+    for (int i = 0; i < count; i++) {
+        seen[i] = atomic_load_explicit(&rooms[room[i]].evidence_here, memory_order_relaxed);
+    }
+}
+
+// Kernels take their arrays as restrict parameters so no runtime alias
+// checks are needed
+static void stats_kernel(int count, const EvidenceByte* restrict seen, int32_t* restrict boredom,
+                         int32_t* restrict fear) {
+    for (int i = 0; i < count; i++) {
+        int b = boredom[i];
+        int f = fear[i];
+        hunter_rule_stats(seen[i], &b, &f);
+        boredom[i] = b;
+        fear[i] = f;
+    }
+}
+
+static int verdict_kernel(int count, const int32_t* restrict boredom, const int32_t* restrict fear,
+                          int8_t* restrict verdict) {
+    int leaving = 0;
+    for (int i = 0; i < count; i++) {
+        int v = hunter_rule_verdict(boredom[i], fear[i]);
+        verdict[i] = (int8_t)v;
+        leaving += v != HUNTER_STAYS;
+    }
+    return leaving;
+}
+
+static void hunter_store_update_stats(struct HunterStore* store) {
+    stats_kernel(store->count, store->seen, store->boredom, store->fear);
+}
+
+static int hunter_store_check_limits(struct HunterStore* store) {
+    return verdict_kernel(store->count, store->boredom, store->fear, store->verdict);
+}
+
+static double layout_aos(struct Hunter* hunters, int count, struct House* house, int rounds, uint64_t seed,
+                         long* leaving) {
+    struct Rng rng;
+    rng_seed(&rng, seed, RNG_STREAM_SETUP);
+    double seconds = 0.0;
+    for (int r = 0; r < rounds; r++) {
+        for (int k = 0; k < house->room_count; k++) {
+            atomic_store_explicit(&house->rooms[k].evidence_here, (EvidenceByte)rng_below(&rng, 128), memory_order_relaxed);
+        }
+        double began = bench_seconds();
+        for (int i = 0; i < count; i++) {
+            struct Hunter* h = &hunters[i];
+            hunter_rule_stats(room_evidence(h->current_room), &h->boredom, &h->fear);
+            if (hunter_rule_verdict(h->boredom, h->fear) != HUNTER_STAYS) {
+                h->boredom = 0;
+                h->fear = 0;
+                (*leaving)++;
+            }
+        }
+        seconds += bench_seconds() - began;
+    }
+    return seconds;
+}
+
+static double layout_soa(struct HunterStore* store, struct House* house, int rounds, uint64_t seed, long* leaving,
+                         double* kernel_seconds) {
+    struct Rng rng;
+    rng_seed(&rng, seed, RNG_STREAM_SETUP);
+    double seconds = 0.0;
+    for (int r = 0; r < rounds; r++) {
+        for (int k = 0; k < house->room_count; k++) {
+            atomic_store_explicit(&house->rooms[k].evidence_here, (EvidenceByte)rng_below(&rng, 128), memory_order_relaxed);
+        }
+        double began = bench_seconds();
+        hunter_store_gather(store, house);
+        double gathered = bench_seconds();
+        hunter_store_update_stats(store);
+        int leaving_now = hunter_store_check_limits(store);
+        *kernel_seconds += bench_seconds() - gathered;
+        if (leaving_now) {
+            for (int i = 0; i < store->count; i++) {
+                if (store->verdict[i] != HUNTER_STAYS) {
+                    store->boredom[i] = 0;
+                    store->fear[i] = 0;
+                }
+            }
+            *leaving += leaving_now;
+        }
+        seconds += bench_seconds() - began;
+    }
+    return seconds;
+}
+
+static bool bench_layout(void) {
+    static const int hunter_counts[] = { 10000, 100000, 1000000 };
+    const long work = 20000000;   // hunter ticks per measurement
+    printf("%9s %7s %13s %13s %15s %8s\n", "hunters", "rounds", "AoS ticks/s", "SoA ticks/s", "SoA phases/s", "speedup");
+    for (size_t n = 0; n < sizeof(hunter_counts) / sizeof(hunter_counts[0]); n++) {
+        int count = hunter_counts[n];
+        int rounds = (int)(work / count);
+        struct House house;
+        if (!house_init(&house, NULL)) return false;
+        struct Hunter* hunters = calloc((size_t)count, sizeof(*hunters));
+        struct HunterStore store;
+        memset(&store, 0, sizeof(store));
+        if (!hunters || !hunter_store_init(&store, count)) {
+            free(hunters);
+            house_cleanup(&house);
+            return false;
+        }
+
+        struct Rng rng;
+        rng_seed(&rng, 7, RNG_STREAM_SETUP);
+        for (int i = 0; i < count; i++) {
+            hunters[i].current_room = &house.rooms[rng_range(&rng, 0, house.room_count)];
+            hunters[i].current_device = EV_EMF;
+            hunter_store_load(&store, &house, &hunters[i]);
+        }
+
+        long aos_leaving = 0;
+        long soa_leaving = 0;
+        double kernel_seconds = 0.0;
+        double aos = layout_aos(hunters, count, &house, rounds, 11, &aos_leaving);
+        double soa = layout_soa(&store, &house, rounds, 11, &soa_leaving, &kernel_seconds);
+
+        // Write every slot back and compare whole hunters, so the store's
+        // load/save round trip is checked along with the counters
+        bool same = aos_leaving == soa_leaving;
+        for (int i = 0; same && i < count; i++) {
+            struct Hunter back = hunters[i];
+            hunter_store_save(&store, i, &house, &back);
+            same = back.boredom == hunters[i].boredom && back.fear == hunters[i].fear
+                && back.current_room == hunters[i].current_room && back.collected == hunters[i].collected
+                && back.current_device == hunters[i].current_device;
+        }
+        double ticks = (double)count * rounds;
+        printf("%9d %7d %13.0f %13.0f %15.0f %7.2fx%s\n", count, rounds, ticks / aos, ticks / soa,
+               ticks / kernel_seconds, aos / soa, same ? "" : "  MISMATCH");
+
+        hunter_store_free(&store);
+        free(hunters);
+        house_cleanup(&house);
+        if (!same) return false;
+    }
+    return true;
+}
+
+// ---- Room false sharing ----
+// One thread per room, each working only on its own room: lock and unlock it,
+// bump the occupancy count, drop and claim evidence, bump a signal word. The
+// rooms sit next to each other in an array. In the old layout (one ~112-byte
+// struct, fields in declaration order) neighbours share cache lines, so the
+// threads fight over lines they never logically share; the split layout gives
+// each room's hot state a line of its own.
+struct PackedRoom {
+    const char* name;
+    bool is_exit;
+    struct House* house;
+    uint32_t conn_first;
+    int conn_count;
+    _Atomic EvidenceByte evidence_here;
+    pthread_mutex_t mutex;
+    struct Hunter** occupants;
+    atomic_int occupancy_count;
+    int occupancy_alloc;
+    int occupancy_limit;
+    atomic_uint signal_gen[ROOM_SIGNAL_COUNT];
+    atomic_int sleepers;
+};
+
+struct ShareWorker {
+    pthread_mutex_t* mutex;       // fields of this worker's room, in either layout
+    atomic_int* count;
+    _Atomic EvidenceByte* evidence;
+    atomic_uint* signal;
+    long iterations;
+    pthread_barrier_t* start;
+    pthread_t thread;
+    double began;
+    double ended;
+};
+
+static void* share_worker_fn(void* arg) {
+    struct ShareWorker* worker = arg;
+    pthread_barrier_wait(worker->start);
+    worker->began = bench_seconds();
+    for (long i = 0; i < worker->iterations; i++) {
+        pthread_mutex_lock(worker->mutex);
+        atomic_fetch_add_explicit(worker->count, 1, memory_order_release);
+        atomic_fetch_sub_explicit(worker->count, 1, memory_order_release);
+        pthread_mutex_unlock(worker->mutex);
+        atomic_fetch_or_explicit(worker->evidence, EV_EMF, memory_order_relaxed);
+        atomic_fetch_and_explicit(worker->evidence, (EvidenceByte)~EV_EMF, memory_order_relaxed);
+        atomic_fetch_add_explicit(worker->signal, 1, memory_order_relaxed);
+    }
+    worker->ended = bench_seconds();
+    return NULL;
+}
+
+// Returns room operations per second, or -1 when threads cannot start
+static double share_round(struct ShareWorker* workers, int count, long iterations) {
+    pthread_barrier_t start;
+    pthread_barrier_init(&start, NULL, (unsigned)count);
+    int started = 0;
+    for (int i = 0; i < count; i++) {
+        workers[i].iterations = iterations;
+        workers[i].start = &start;
+        if (pthread_create(&workers[i].thread, NULL, share_worker_fn, &workers[i]) != 0) break;
+        started++;
+    }
+    if (started < count) {
+        // The barrier can never open; nothing sensible to measure
+        fprintf(stderr, "Failed to start room threads\n");
+        exit(1);
+    }
+    double begin = 0.0;
+    double end = 0.0;
+    for (int i = 0; i < count; i++) {
+        pthread_join(workers[i].thread, NULL);
+        if (i == 0 || workers[i].began < begin) begin = workers[i].began;
+        if (workers[i].ended > end) end = workers[i].ended;
+    }
+    pthread_barrier_destroy(&start);
+    return end > begin ? (double)iterations * count / (end - begin) : -1.0;
+}
+
+static bool bench_falseshare(void) {
+    static const int thread_counts[] = { 2, 4, 8 };
+    const long total = 4000000;   // room operations per measurement
+    printf("online cores %d, packed room %zu bytes, split room %zu bytes (hot line %zu)\n",
+           runner_default_workers(), sizeof(struct PackedRoom), sizeof(struct Room), offsetof(struct Room, name));
+    printf("%8s %16s %16s %8s\n", "threads", "packed ops/s", "split ops/s", "speedup");
+
+    for (size_t t = 0; t < sizeof(thread_counts) / sizeof(thread_counts[0]); t++) {
+        int count = thread_counts[t];
+        struct PackedRoom* packed = calloc((size_t)count, sizeof(*packed));
+        struct Room* split = aligned_alloc(CACHE_LINE_SIZE, (size_t)count * sizeof(*split));
+        struct ShareWorker* workers = calloc((size_t)count, sizeof(*workers));
+        if (!packed || !split || !workers) {
+            free(packed);
+            free(split);
+            free(workers);
+            return false;
+        }
+
+        for (int i = 0; i < count; i++) {
+            pthread_mutex_init(&packed[i].mutex, NULL);
+            workers[i].mutex = &packed[i].mutex;
+            workers[i].count = &packed[i].occupancy_count;
+            workers[i].evidence = &packed[i].evidence_here;
+            workers[i].signal = &packed[i].signal_gen[ROOM_SIGNAL_EVIDENCE];
+        }
+        double packed_rate = share_round(workers, count, total / count);
+
+        for (int i = 0; i < count; i++) {
+            room_init(&split[i], "Split Room", false);
+            workers[i].mutex = &split[i].mutex;
+            workers[i].count = &split[i].occupancy_count;
+            workers[i].evidence = &split[i].evidence_here;
+            workers[i].signal = &split[i].signal_gen[ROOM_SIGNAL_EVIDENCE];
+        }
+        double split_rate = share_round(workers, count, total / count);
+
+        printf("%8d %16.0f %16.0f %7.2fx\n", count, packed_rate, split_rate, split_rate / packed_rate);
+        for (int i = 0; i < count; i++) {
+            pthread_mutex_destroy(&packed[i].mutex);
+            pthread_mutex_destroy(&split[i].mutex);
+        }
+        free(packed);
+        free(split);
+        free(workers);
+    }
+    return true;
+}
+
+// ---- Per-game memory ----
+// Virtual-clock games on one worker, three ways: a fresh house and fresh
+// entities per game (every room lock initialised and destroyed each time), a
+// reused house with the event queue on the heap (the batch runner before the
+// game arena), and a reused house whose per-game memory comes from an arena
+// that house_reset rewinds.
+enum ArenaMode { ARENA_FRESH, ARENA_HEAP, ARENA_REUSE };
+
+static bool arena_round(enum ArenaMode mode, long games, double* games_per_sec, long* blocks) {
+    enum { HUNTERS = 4 };
+    struct House house;
+    struct Hunter hunters[HUNTERS];
+    struct Ghost ghost;
+    struct Arena game;
+    arena_init(&game, 0);
+    bool ok = true;
+    bool ready = false;
+
+    double start = bench_seconds();
+    for (long g = 0; ok && g < games; g++) {
+        if (!ready) {
+            if (!house_init(&house, NULL)) return false;
+            house.arena = mode == ARENA_REUSE ? &game : NULL;
+            memset(hunters, 0, sizeof(hunters));
+            memset(&ghost, 0, sizeof(ghost));
+            for (int i = 0; i < HUNTERS; i++) {
+                hunters[i].id = i + 1;
+                snprintf(hunters[i].name, sizeof(hunters[i].name), "Hunter %d", i + 1);
+            }
+            ready = true;
+        } else {
+            house_reset(&house);
+        }
+
+        uint64_t run_seed = sim_run_seed(1, (uint64_t)g);
+        sim_setup_ghosts(&house, &ghost, 1, run_seed);
+        for (int i = 0; i < HUNTERS; i++) {
+            sim_setup_hunter(&house, &hunters[i], run_seed);
+        }
+        struct SimResult result;
+        ok = sim_run(SIM_ENGINE_EVENTS, &house, &ghost, 1, hunters, HUNTERS, &result);
+
+        if (mode == ARENA_FRESH || !ok || g + 1 == games) {
+            for (int i = 0; i < HUNTERS; i++) {
+                stack_free(&hunters[i].breadcrumb);
+            }
+            house_cleanup(&house);
+            ready = false;
+        }
+    }
+    double seconds = bench_seconds() - start;
+
+    *games_per_sec = seconds > 0 ? games / seconds : 0.0;
+    *blocks = game.blocks;
+    arena_free(&game);
+    return ok;
+}
+
+static bool bench_arena(void) {
+    static const char* const names[] = { "fresh house", "heap queue", "game arena" };
+    const long games = 200000;
+    printf("%-12s %12s %14s\n", "per game", "games/sec", "arena blocks");
+    for (int mode = ARENA_FRESH; mode <= ARENA_REUSE; mode++) {
+        double rate = 0.0;
+        long blocks = 0;
+        if (!arena_round((enum ArenaMode)mode, games, &rate, &blocks)) return false;
+        printf("%-12s %12.0f %14ld\n", names[mode], rate, blocks);
+    }
+    return true;
+}
+
+// ---- Lockstep lanes ----
+// One worker plays the same batch on the event engine and in 8, 16 and 32
+// lockstep lanes. The lanes must reproduce the event engine's statistics
+// exactly; the interesting number is games per second on one core.
+static bool lockstep_stats_match(const struct BatchStats* a, const struct BatchStats* b) {
+    if (a->runs != b->runs || a->wins != b->wins || a->cases_solved != b->cases_solved) return false;
+    if (a->total_duration_ms != b->total_duration_ms || a->total_ticks != b->total_ticks) return false;
+    if (a->van_trips != b->van_trips || a->van_trip_ticks != b->van_trip_ticks ||
+        a->van_trips_abandoned != b->van_trips_abandoned) {
+        return false;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (a->exit_counts[i] != b->exit_counts[i]) return false;
+    }
+    for (int i = 0; i < 8; i++) {
+        if (a->evidence_bits_histogram[i] != b->evidence_bits_histogram[i]) return false;
+    }
+    for (int g = 0; g < GHOST_TYPE_COUNT; g++) {
+        if (a->by_ghost[g].runs != b->by_ghost[g].runs || a->by_ghost[g].wins != b->by_ghost[g].wins) return false;
+    }
+    return true;
+}
+
+static bool bench_lockstep(void) {
+    static const int lane_counts[] = { 0, 8, 16, 32 };   // 0 = event engine
+    struct Hunter roster[4];
+    memset(roster, 0, sizeof(roster));
+    for (int i = 0; i < 4; i++) {
+        roster[i].id = i + 1;
+        snprintf(roster[i].name, sizeof(roster[i].name), "Hunter %d", i + 1);
+    }
+
+    struct BatchStats reference;
+    double reference_rate = 0.0;
+    printf("%-14s %9s %12s %9s %8s\n", "engine", "runs", "games/sec", "speedup", "matches");
+    for (size_t n = 0; n < sizeof(lane_counts) / sizeof(lane_counts[0]); n++) {
+        struct RunnerConfig config = {
+            .workers = 1,
+            .runs = 200000,
+            .seed = 1,
+            .first_run = 0,
+            .engine = lane_counts[n] ? SIM_ENGINE_LOCKSTEP : SIM_ENGINE_EVENTS,
+            .roster = roster,
+            .hunter_count = 4,
+            .ghost_count = 1,
+            .room_capacity = MAX_ROOM_OCCUPANCY,
+            .lanes = lane_counts[n]
+        };
+        struct BatchStats stats;
+        double seconds = 0.0;
+        if (!runner_run(&config, &stats, &seconds)) return false;
+        double rate = seconds > 0 ? stats.runs / seconds : 0.0;
+        if (n == 0) {
+            reference = stats;
+            reference_rate = rate;
+        }
+
+        char label[32];
+        if (lane_counts[n]) {
+            snprintf(label, sizeof(label), "lockstep x%d", lane_counts[n]);
+        } else {
+            snprintf(label, sizeof(label), "events");
+        }
+        printf("%-14s %9ld %12.0f %8.2fx %8s\n", label, stats.runs, rate,
+               reference_rate > 0 ? rate / reference_rate : 0.0,
+               lockstep_stats_match(&reference, &stats) ? "yes" : "NO");
+    }
+    return true;
+}
+
+static const struct Benchmark benchmarks[] = {
+    { "entities", "ticks/sec as hunter and ghost counts grow", bench_entities },
+    { "maps",     "generate, save and load large house maps", bench_maps },
+    { "routing",  "return-to-van moves with and without exit routes", bench_routing },
+    { "stack",    "breadcrumb push/pop/clear: linked list vs array vs ring", bench_stack },
+    { "evidence", "room evidence contention: mutex vs atomic, 4/64/512 hunters", bench_evidence },
+    { "transfer", "concurrent room moves: stress test and lock traffic", bench_transfer },
+    { "deduce",   "evidence deduction: ghost scans vs the 128-entry table", bench_deduce },
+    { "casefile", "private vs shared evidence: game length and win rate", bench_casefile },
+    { "teardown", "stopping ghost threads: usleep ticks vs the interruptible waker", bench_teardown },
+    { "wakeup",   "evidence-to-hunter reaction: fixed ticks vs reactive room signals", bench_wakeup },
+    { "cadence",  "tick period under load: relative usleep vs absolute deadlines", bench_cadence },
+    { "pool",     "real-time games on the worker pool: 1k to 100k hunters", bench_pool },
+    { "layout",   "R-17/R-19 over 10k-1M hunters: struct Hunter vs the SoA store", bench_layout },
+    { "falseshare", "threads on adjacent rooms: packed vs cache-line split Room", bench_falseshare },
+    { "arena", "per-game memory: fresh house vs reused house vs game arena", bench_arena },
+    { "lockstep", "games/sec on one core: event engine vs 8/16/32 lockstep lanes", bench_lockstep },
+};
+
+bool bench_run(const char* name) {
+    size_t count = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+    if (strcmp(name, "list") == 0) {
+        for (size_t i = 0; i < count; i++) {
+            printf("  %-12s %s\n", benchmarks[i].name, benchmarks[i].description);
+        }
+        return true;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(name, benchmarks[i].name) == 0) {
+            printf("=== BENCH %s ===\n", benchmarks[i].name);
+            double started = bench_seconds();
+            bool ok = benchmarks[i].run();
+            printf("(%.2f s)\n", bench_seconds() - started);
+            return ok;
+        }
+    }
+
+    fprintf(stderr, "Unknown benchmark '%s' (try --bench list)\n", name);
+    return false;
+}
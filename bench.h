@@ -0,0 +1,15 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdbool.h>
+
+// Micro and scaling benchmarks, selected with --bench NAME
+
+/**
+ * @brief Run one benchmark and print its table to stdout.
+ * @param[in] name Benchmark name; "list" prints the available names.
+ * @return false when the name is unknown or the benchmark failed.
+ */
+bool bench_run(const char* name);
+
+#endif // BENCH_H
@@ -0,0 +1,159 @@
+#include "converge.h"
+#include "helpers.h"
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+// ---- Intervals ----
+// Wilson score half-width of a proportion p seen over n trials; unlike the
+// normal interval it stays honest for the rare wins of hard ghost types
+static double wilson_half(double p, double n) {
+    if (n <= 0.0) return 1.0;
+    double z2 = CONVERGE_Z * CONVERGE_Z;
+    return CONVERGE_Z / (1.0 + z2 / n) * sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n));
+}
+
+// Fewest trials at which the interval around p is no wider than half, or
+// CONVERGE_TRIALS_LIMIT when even that many are not enough. Past 2^53 doubles
+// no longer hold every integer and the bisection below would stop narrowing.
+static double wilson_trials(double p, double half) {
+    double low = 1.0, high = 1.0;
+    while (wilson_half(p, high) > half) {
+        if (high >= CONVERGE_TRIALS_LIMIT) return CONVERGE_TRIALS_LIMIT;
+        low = high;
+        high *= 2.0;
+    }
+    while (high - low > 1.0) {
+        double mid = floor((low + high) / 2.0);
+        if (wilson_half(p, mid) > half) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return high;
+}
+
+// Intervals for every type played so far, and the games the widest one needs
+static void converge_measure(const struct BatchStats* stats, const struct ConvergeConfig* target,
+                             struct Convergence* result) {
+    double win_target = target->win_points / 100.0;
+    double needed = 0.0;
+    bool all = true;
+    int played = 0;
+
+    for (int g = 0; g < GHOST_TYPE_COUNT; g++) {
+        const struct GhostTypeStats* ghost = &stats->by_ghost[g];
+        struct GhostConvergence* out = &result->by_ghost[g];
+        memset(out, 0, sizeof(*out));
+        out->solve_half_ms = INFINITY;
+        if (ghost->runs == 0) continue;
+        played++;
+
+        double runs = (double)ghost->runs;
+        double wins = (double)ghost->wins;
+        out->win = wins / runs;
+        out->win_half = wilson_half(out->win, runs);
+        double type_runs = wilson_trials(out->win, win_target);
+        bool win_ok = out->win_half <= win_target;
+
+        bool solve_ok = true;
+        if (ghost->wins > 0) out->solve_ms = (double)ghost->solve_ms_total / wins;
+        if (ghost->wins >= CONVERGE_MIN_WINS) {
+            double variance = (ghost->solve_ms_squares - wins * out->solve_ms * out->solve_ms) / (wins - 1.0);
+            double spread = sqrt(fmax(variance, 0.0));
+            out->solve_half_ms = CONVERGE_Z * spread / sqrt(wins);
+        }
+        if (target->solve_ms > 0.0) {
+            solve_ok = out->solve_half_ms <= target->solve_ms;
+            double wins_needed = CONVERGE_MIN_WINS;
+            if (isfinite(out->solve_half_ms)) {
+                double spread = out->solve_half_ms * sqrt(wins) / CONVERGE_Z;
+                wins_needed = fmax(wins_needed, ceil(pow(CONVERGE_Z * spread / target->solve_ms, 2.0)));
+            }
+            // Until the type has won at all, its win rate gives no projection: double up
+            double solve_runs = ghost->wins > 0 ? wins_needed / out->win : 2.0 * runs;
+            type_runs = fmax(type_runs, solve_runs);
+        }
+
+        out->converged = win_ok && solve_ok;
+        all = all && out->converged;
+        // Types are drawn uniformly, so the batch needs runs / share of this type
+        needed = fmax(needed, type_runs * (double)stats->runs / runs);
+    }
+
+    result->converged = all && played > 0;
+    result->runs_needed = needed < (double)LONG_MAX ? (long)ceil(needed) : LONG_MAX;
+}
+
+// ---- Rounds ----
+bool converge_run(const struct RunnerConfig* config, const struct ConvergeConfig* target, struct BatchStats* stats,
+                  struct Convergence* result, double* seconds) {
+    struct RunnerConfig round_config = *config;
+    long max_runs = target->max_runs > 0 ? target->max_runs : CONVERGE_DEFAULT_MAX_RUNS;
+    long round = CONVERGE_MIN_ROUND < max_runs ? CONVERGE_MIN_ROUND : max_runs;
+
+    memset(stats, 0, sizeof(*stats));
+    memset(result, 0, sizeof(*result));
+    *seconds = 0.0;
+
+    for (;;) {
+        round_config.runs = round;
+        round_config.first_run = config->first_run + (uint64_t)stats->runs;
+        struct BatchStats round_stats;
+        double round_seconds = 0.0;
+        bool ok = runner_run(&round_config, &round_stats, &round_seconds);
+        *seconds += round_seconds;
+        if (!ok) return false;
+        batch_stats_merge(stats, &round_stats);
+        result->rounds++;
+
+        converge_measure(stats, target, result);
+        if (result->converged || stats->runs >= max_runs) return true;
+
+        // Aim a little past the projection, but never more than double what
+        // has been seen: the spread behind the projection is an estimate too
+        long wanted = result->runs_needed - stats->runs;
+        wanted += wanted / 10;
+        if (wanted < CONVERGE_MIN_ROUND) wanted = CONVERGE_MIN_ROUND;
+        if (wanted > stats->runs) wanted = stats->runs;
+        round = wanted < max_runs - stats->runs ? wanted : max_runs - stats->runs;
+    }
+}
+
+// ---- Output ----
+void converge_print(const struct Convergence* result, const struct ConvergeConfig* target,
+                    const struct BatchStats* stats) {
+    printf("\n=== CONVERGENCE ===\n");
+    printf("Target: win rate +-%.2f pp", target->win_points);
+    if (target->solve_ms > 0.0) printf(", time to solve +-%.2f s", target->solve_ms / 1000.0);
+    printf(" per ghost type at 95%% confidence\n");
+
+    int open = 0;
+    for (int g = 0; g < GHOST_TYPE_COUNT; g++) {
+        if (stats->by_ghost[g].runs > 0 && !result->by_ghost[g].converged) open++;
+    }
+    if (result->converged) {
+        printf("Converged after %ld runs in %d rounds\n", stats->runs, result->rounds);
+    } else {
+        printf("Stopped at the run cap after %ld runs in %d rounds: %d ghost types still too wide "
+               "(about %ld runs needed)\n", stats->runs, result->rounds, open, result->runs_needed);
+    }
+
+    printf("\n%-12s %8s %7s %6s %9s %7s %5s\n", "ghost", "runs", "win%", "+-", "solve(s)", "+-", "done");
+    const enum GhostType* ghost_types = NULL;
+    int ghost_count = get_all_ghost_types(&ghost_types);
+    for (int g = 0; g < ghost_count && g < GHOST_TYPE_COUNT; g++) {
+        const struct GhostConvergence* ghost = &result->by_ghost[g];
+        if (stats->by_ghost[g].runs == 0) continue;
+        printf("%-12s %8ld %6.1f%% %6.2f", ghost_to_string(ghost_types[g]), stats->by_ghost[g].runs,
+               100.0 * ghost->win, 100.0 * ghost->win_half);
+        if (isfinite(ghost->solve_half_ms)) {
+            printf(" %9.2f %7.2f", ghost->solve_ms / 1000.0, ghost->solve_half_ms / 1000.0);
+        } else {
+            printf(" %9s %7s", "-", "-");
+        }
+        printf(" %5s\n", ghost->converged ? "yes" : "no");
+    }
+}
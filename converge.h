@@ -0,0 +1,66 @@
+#ifndef CONVERGE_H
+#define CONVERGE_H
+
+#include "runner.h"
+#include <stdbool.h>
+
+// Batches played until the numbers are good enough instead of for a fixed
+// count. Games are played in rounds; after each round every ghost type's win
+// rate (Wilson score interval) and mean time to solve (normal interval over
+// the games won) are checked against the requested half-widths, and the next
+// round is sized from the current spread to what the widest metric still
+// needs. Round k continues at game index first_run + (games so far), so the
+// games played are exactly those of one batch of the final size.
+
+#define CONVERGE_Z 1.96                // two-sided 95% normal quantile
+#define CONVERGE_MIN_WINS 10           // wins before a solve-time interval is trusted
+#define CONVERGE_MIN_ROUND 1024        // smallest round worth starting the workers for
+#define CONVERGE_DEFAULT_MAX_RUNS 10000000L
+#define CONVERGE_MIN_WIN_POINTS 0.01   // smallest --precision: already ~1e8 games per type
+#define CONVERGE_TRIALS_LIMIT 9007199254740992.0  // 2^53, projections stop growing here
+
+// When to stop
+struct ConvergeConfig {
+    double win_points;     // wanted half-width of every type's win-rate interval, percentage points
+    double solve_ms;       // wanted half-width of every type's mean time to solve, 0 = not tracked
+    long max_runs;         // stop here even if some interval is still too wide
+};
+
+// Where one ghost type stands
+struct GhostConvergence {
+    double win;            // win rate, 0..1
+    double win_half;       // half-width of its interval, 0..1
+    double solve_ms;       // mean length of the games won
+    double solve_half_ms;  // half-width of its interval, INFINITY before CONVERGE_MIN_WINS wins
+    bool converged;
+};
+
+struct Convergence {
+    int rounds;
+    bool converged;        // every type met both targets
+    long runs_needed;      // projected total for the widest metric
+    struct GhostConvergence by_ghost[GHOST_TYPE_COUNT];
+};
+
+/**
+ * @brief Play rounds of config until every ghost type meets target.
+ * @param[in] config Batch description; runs is ignored.
+ * @param[in] target Precision wanted and the run cap.
+ * @param[out] stats Merged totals of every round.
+ * @param[out] result Intervals after the last round.
+ * @param[out] seconds Wall-clock time spent playing.
+ * @return false when a round failed.
+ */
+bool converge_run(const struct RunnerConfig* config, const struct ConvergeConfig* target, struct BatchStats* stats,
+                  struct Convergence* result, double* seconds);
+
+/**
+ * @brief Print the per-type intervals and whether the batch converged.
+ * @param[in] result Output of converge_run.
+ * @param[in] target Precision that was asked for.
+ * @param[in] stats Totals the intervals came from.
+ */
+void converge_print(const struct Convergence* result, const struct ConvergeConfig* target,
+                    const struct BatchStats* stats);
+
+#endif // CONVERGE_H
@@ -2,23 +2,37 @@
 #define DEFS_H
 
 #include "roomstack.h"   // <- breadcrumb stack
+#include "rng.h"
+#include "map.h"
+#include "simclock.h"
+#include "arena.h"
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
 #include <semaphore.h>
 #include <pthread.h>
 
-#define MAX_ROOM_NAME 64
 #define MAX_HUNTER_NAME 64
-#define MAX_ROOMS 24
-#define MAX_ROOM_OCCUPANCY 8
-#define MAX_CONNECTIONS 8
+#define MAX_ROOM_OCCUPANCY 8   // default per-room hunter limit; house_set_room_capacity changes it
 #define ENTITY_BOREDOM_MAX 15
 #define HUNTER_FEAR_MAX 15
 #define DEFAULT_GHOST_ID 68057
+#define HUNTER_TICK_MS 200   // hunters act every 200 ms (real or virtual)
+#define GHOST_TICK_MS 300    // the ghost acts every 300 ms
+#define HUNTER_BREADCRUMB_DEPTH 128 // rooms remembered on the trail; older ones are forgotten
+#define CACHE_LINE_SIZE 64   // alignment that keeps per-room hot state apart
 
 typedef unsigned char EvidenceByte; // bitmask
 
 enum LogReason { LR_EVIDENCE=0, LR_BORED=1, LR_AFRAID=2 };
 
+// Changes a room announces to entities waiting on it (reactive wakeups only)
+enum RoomSignal {
+    ROOM_SIGNAL_EVIDENCE = 0,  // the ghost left new evidence; hunters wait on this
+    ROOM_SIGNAL_ARRIVAL = 1,   // a hunter walked in; the ghost waits on this
+    ROOM_SIGNAL_COUNT
+};
+
 enum EvidenceType {
     EV_EMF = 1<<0,
     EV_ORBS = 1<<1,
@@ -57,55 +71,110 @@ enum GhostType {
 };
 
 struct CaseFile {
-    EvidenceByte collected;
-    bool solved;
+    EvidenceByte collected;  // evidence every hunter has reported, guarded by mutex
+    atomic_bool solved;      // set under mutex once collected names one ghost; read lock-free
     sem_t mutex;
 };
 
+// A room is two cache lines. The first holds everything hunters and ghosts
+// write during play, so two busy rooms never share a line; the second holds
+// the read-mostly layout fields, which every core can cache at once. Names and
+// doors live in the shared HouseMap, indexed by 16- or 32-bit room numbers.
 struct Room {
-    char name[MAX_ROOM_NAME];
-    bool is_exit;
-    struct Room* connections[MAX_CONNECTIONS];
+    // Hot: written every tick
+    _Alignas(CACHE_LINE_SIZE) pthread_mutex_t mutex; // guards the occupancy list
+    atomic_uint signal_gen[ROOM_SIGNAL_COUNT]; // futex words, bumped by room_signal
+    atomic_int occupancy_count; // written under mutex, read lock-free by presence checks
+    atomic_int sleepers;       // threads in room_wait_signal; lets room_signal skip the wake syscall
+    _Atomic EvidenceByte evidence_here; // deposited with fetch-or, claimed with fetch-and; no lock
+
+    // Cold: set when the house is built; occupants only moves when it grows
+    _Alignas(CACHE_LINE_SIZE) const char* name; // owned by the house map
+    struct House* house;       // owning house, for neighbour lookups
+    struct Hunter** occupants; // Track hunters in room (grows on demand, cache-line aligned)
+    uint32_t conn_first;       // first adjacency entry of this room in the house map
     int conn_count;
-    EvidenceByte evidence_here;
-    pthread_mutex_t mutex;
-    struct Hunter* occupants[MAX_ROOM_OCCUPANCY]; // Track hunters in room
-    int occupancy_count;
+    int occupancy_alloc;       // slots allocated in occupants
+    int occupancy_limit;       // hunters allowed at once, 0 = unlimited
+    bool is_exit;
 };
+_Static_assert(offsetof(struct Room, name) == CACHE_LINE_SIZE, "hot room state must fit one cache line");
 
 struct Ghost {
     int id;
     enum GhostType type;
     struct Room* current_room;
     pthread_t thread;
-    bool running;
+    atomic_bool running;     // cleared to stop the ghost; see house->waker
+    struct TickSchedule schedule; // absolute tick deadlines (threads engine)
+    int boredom;
+    int loop_count;
+    struct Rng rng;          // per-entity stream derived from the run seed
 };
 
+// Fields every tick touches come first so they share the first cache line;
+// identity, thread and bookkeeping state follow
 struct Hunter {
-    int id;
-    char name[MAX_HUNTER_NAME];
     struct Room* current_room;
-    EvidenceByte collected;
-    enum LogReason exit_reason;
-    pthread_t thread;
     int boredom;
     int fear;
-    struct RoomStack breadcrumb; // <- now complete
+    EvidenceByte collected;
+    bool returning_to_van;
     enum EvidenceType current_device; // R-16.3: hunter starts with random device
+    int room_slot;           // index in current_room->occupants, -1 when not listed
+    int trip_ticks;          // moves made on the current return to the van
+    struct Rng rng;          // per-entity stream derived from the run seed
+    atomic_bool running;     // cleared to pull the hunter out; see house->waker
+    enum LogReason exit_reason;
+    int id;
+    int van_trips;           // returns that reached an exit this game
+    int van_trip_ticks;      // moves spent returning, abandoned returns included
+    int van_trips_abandoned; // returns cut short by leaving the house
+    struct RoomStack breadcrumb; // <- now complete; zeroed with the hunter, buffer reused across games
+    struct TickSchedule schedule; // absolute tick deadlines (threads engine)
+    pthread_t thread;
+    char name[MAX_HUNTER_NAME];
 };
 
 struct House {
-    struct Room rooms[MAX_ROOMS];
+    struct Room* rooms;          // room_count entries, one per map room
     int room_count;
+    const struct HouseMap* map;  // shared layout; outlives the house
+    bool random_return;          // returning hunters ignore exit_hop and wander (for comparison)
+    bool private_evidence;       // hunters skip the case file and play until they leave (for comparison)
+    bool reactive;               // threaded entities wake on room signals as well as their tick
+    int pool_workers;            // pool engine worker threads, 0 = one per core
+    struct Arena* arena;         // per-game scratch, rewound by house_reset; NULL = heap
+    long long log_run;           // batch game index naming the CSV log files, LOG_NO_RUN when interactive
     struct Room* starting_room;
     struct CaseFile casefile;
+    struct SimWaker waker;       // cuts entity sleeps short on stop or when the case is solved
     pthread_mutex_t house_mutex; // Lock for one hunter at a time
 };
 
+// Neighbour idx (0 <= idx < conn_count) of a room, read from the map's CSR adjacency
+static inline struct Room* room_neighbor(const struct Room* room, int idx) {
+    const struct House* house = room->house;
+    return &house->rooms[map_adj(house->map, room->conn_first + (uint32_t)idx)];
+}
+
+// Neighbour one step closer to the nearest exit; NULL in an exit room or when
+// no exit can be reached
+static inline struct Room* room_exit_hop(const struct Room* room) {
+    const struct House* house = room->house;
+    uint32_t hop = house->map->exit_hop[room - house->rooms];
+    return hop == MAP_NO_ROUTE ? NULL : &house->rooms[hop];
+}
+
 // Function prototypes
 void room_init(struct Room* room, const char* name, bool is_exit);
-void room_connect(struct Room* a, struct Room* b);
 void* ghost_thread_fn(void* arg);
 void* hunter_thread_fn(void* arg);
 
+// Per-tick entity logic shared by the thread functions and the event engine
+void ghost_start(struct Ghost* g);
+bool ghost_tick(struct Ghost* g);   // false once the ghost has left or was stopped
+void hunter_start(struct Hunter* h);
+bool hunter_tick(struct Hunter* h); // false once the hunter has exited the house
+
 #endif // DEFS_H
@@ -0,0 +1,115 @@
+#include "engine.h"
+#include "simclock.h"
+#include "arena.h"
+#include <stdlib.h>
+
+enum EngineEntity { ENGINE_GHOST = 0, ENGINE_HUNTER = 1 };
+
+// A pending wake-up; order breaks ties so equal times run in scheduling order
+struct EngineEvent {
+    long long time_ms;
+    unsigned long order;
+    enum EngineEntity kind;
+    int index;
+};
+
+// Binary min-heap keyed by (time_ms, order)
+struct EventQueue {
+    struct EngineEvent* items;
+    int count;
+    int capacity;
+    unsigned long next_order;
+};
+
+static bool event_before(const struct EngineEvent* a, const struct EngineEvent* b) {
+    if (a->time_ms != b->time_ms) return a->time_ms < b->time_ms;
+    return a->order < b->order;
+}
+
+static void queue_push(struct EventQueue* queue, long long time_ms, enum EngineEntity kind, int index) {
+    // Every entity has at most one pending event, so capacity never runs out
+    int child = queue->count++;
+    struct EngineEvent event = { time_ms, queue->next_order++, kind, index };
+
+    while (child > 0) {
+        int parent = (child - 1) / 2;
+        if (!event_before(&event, &queue->items[parent])) break;
+        queue->items[child] = queue->items[parent];
+        child = parent;
+    }
+    queue->items[child] = event;
+}
+
+static bool queue_pop(struct EventQueue* queue, struct EngineEvent* out) {
+    if (queue->count == 0) return false;
+    *out = queue->items[0];
+
+    struct EngineEvent last = queue->items[--queue->count];
+    int parent = 0;
+    for (;;) {
+        int child = parent * 2 + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count && event_before(&queue->items[child + 1], &queue->items[child])) {
+            child++;
+        }
+        if (!event_before(&queue->items[child], &last)) break;
+        queue->items[parent] = queue->items[child];
+        parent = child;
+    }
+    if (queue->count > 0) queue->items[parent] = last;
+    return true;
+}
+
+bool engine_run(struct Ghost* ghosts, int ghost_count, struct Hunter* hunters, int hunter_count,
+                long long* duration_ms, long* ticks, struct Arena* arena) {
+    struct EventQueue queue = { NULL, 0, hunter_count + ghost_count, 0 };
+    size_t bytes = (size_t)queue.capacity * sizeof(*queue.items);
+    queue.items = arena ? arena_alloc(arena, bytes, _Alignof(struct EngineEvent)) : malloc(bytes);
+    if (!queue.items) return false;
+
+    long long start_ms = simclock_wall_ms();
+    long long now_ms = start_ms;
+    simclock_use_virtual(&now_ms);
+
+    // Same start order as the threaded mode: ghosts first, then every hunter
+    for (int i = 0; i < ghost_count; i++) {
+        ghost_start(&ghosts[i]);
+        queue_push(&queue, now_ms, ENGINE_GHOST, i);
+    }
+    for (int i = 0; i < hunter_count; i++) {
+        hunter_start(&hunters[i]);
+        queue_push(&queue, now_ms, ENGINE_HUNTER, i);
+    }
+
+    int active_hunters = hunter_count;
+    long long last_exit_ms = now_ms;
+    long executed = 0;
+    struct EngineEvent event;
+
+    while (active_hunters > 0 && queue_pop(&queue, &event)) {
+        now_ms = event.time_ms;
+        executed++;
+
+        if (event.kind == ENGINE_GHOST) {
+            if (ghost_tick(&ghosts[event.index])) {
+                queue_push(&queue, now_ms + GHOST_TICK_MS, ENGINE_GHOST, event.index);
+            }
+        } else if (hunter_tick(&hunters[event.index])) {
+            queue_push(&queue, now_ms + HUNTER_TICK_MS, ENGINE_HUNTER, event.index);
+        } else {
+            active_hunters--;
+            last_exit_ms = now_ms;
+        }
+    }
+
+    // After all hunters finish, stop the ghosts
+    for (int i = 0; i < ghost_count; i++) {
+        atomic_store(&ghosts[i].running, false);
+    }
+
+    simclock_use_virtual(NULL);
+    if (!arena) free(queue.items);
+    if (duration_ms) *duration_ms = last_exit_ms - start_ms;
+    if (ticks) *ticks = executed;
+    return true;
+}
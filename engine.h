@@ -0,0 +1,24 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include "defs.h"
+
+/**
+ * @brief Run one game as a discrete-event simulation on a virtual clock.
+ *        Entities wake from a priority queue (hunters every HUNTER_TICK_MS,
+ *        the ghost every GHOST_TICK_MS) and run the same tick logic as the
+ *        thread functions, without sleeping. Log timestamps come from the
+ *        virtual clock, which starts at the current wall-clock time.
+ * @param[in,out] ghosts Ghosts prepared for a new game.
+ * @param[in] ghost_count Number of ghosts.
+ * @param[in,out] hunters Hunters prepared for a new game.
+ * @param[in] hunter_count Number of hunters.
+ * @param[out] duration_ms Virtual time from start until the last hunter exits.
+ * @param[out] ticks Number of entity ticks executed (optional).
+ * @param[in,out] arena Per-game scratch for the event queue, NULL = heap.
+ * @return false when the event queue could not be allocated.
+ */
+bool engine_run(struct Ghost* ghosts, int ghost_count, struct Hunter* hunters, int hunter_count,
+                long long* duration_ms, long* ticks, struct Arena* arena);
+
+#endif // ENGINE_H
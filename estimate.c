@@ -0,0 +1,903 @@
+#include "estimate.h"
+#include "helpers.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TYPE_BITS 3                              // evidence bits of one ghost type
+#define SUBSETS (1 << TYPE_BITS)                 // sets of those bits
+#define UNKNOWN SUBSETS                          // memory/known value: nothing remembered
+#define MEMORIES (UNKNOWN + 1)
+#define DEVICE_COUNT 7
+#define BLIND TYPE_BITS                          // device class that finds none of the type's bits
+#define DEVICE_CLASSES (TYPE_BITS + 1)
+#define BOREDOM_STATES ENTITY_BOREDOM_MAX        // a hunter reaching the max leaves at once
+#define FEAR_STATES HUNTER_FEAR_MAX
+#define GHOST_BOREDOM_STATES (ENTITY_BOREDOM_MAX + 1)  // a ghost at the max stops on its next tick
+#define FEAR_STRIDE 16                           // fear states padded so rows stay vector-aligned
+#define CELLS (BOREDOM_STATES * FEAR_STRIDE)     // boredom/fear states of one block
+
+// Every tick raises boredom or fear, and fear never falls, so no hunter
+// outlives this many ticks
+#define MAX_HUNTER_TICKS (BOREDOM_STATES * FEAR_STATES + 1)
+
+// Blocks lighter than this are dropped rather than followed, and those
+// lighter than FORGETFUL stop remembering evidence: they are folded into the
+// block that knows nothing about the rooms behind and ahead
+#define NEGLIGIBLE 1e-9
+#define FORGETFUL 1e-5
+
+// The game is followed until the chance that any hunter is still inside
+// falls below this
+#define SETTLED 1e-6
+
+// Same time base as the lockstep engine
+#define STEP_MS 100
+#define GHOST_STEPS (GHOST_TICK_MS / STEP_MS)
+#define HUNTER_STEPS (HUNTER_TICK_MS / STEP_MS)
+
+// R-20.2: a hunter that finds nothing heads back with 20% chance, and with
+// 30% more when the room holds evidence its device cannot see
+#define RETURN_CHANCE 0.20
+#define SWAP_CHANCE 0.30
+
+// Hunter states sharing everything but boredom and fear. A position is a
+// room together with the room the hunter came from. Remembering what was
+// left one step back is what makes a hunter bouncing between a leaf room and
+// its hub see the same evidence again, as the played game does. What the
+// hunter has claimed never changes where it goes or what it sees, so it is
+// not part of the state: each block carries its mass split by claimed set.
+struct BlockState {
+    uint32_t position;
+    int memory;                 // type bits left in the room it came from
+    int known;                  // type bits it left here two ticks ago
+    int returning;
+    int device;                 // device class: finds type bit k, or BLIND
+};
+
+// memory and known are UNKNOWN when there is no such room, or when the block
+// was too light to be worth remembering for
+static uint64_t block_key(const struct BlockState* s) {
+    uint64_t key = s->position;
+    key = key * MEMORIES + (uint64_t)s->memory;
+    key = key * MEMORIES + (uint64_t)s->known;
+    key = key * 2 + (uint64_t)s->returning;
+    return key * DEVICE_CLASSES + (uint64_t)s->device;
+}
+
+static struct BlockState block_state(uint64_t key) {
+    struct BlockState s;
+    s.device = (int)(key % DEVICE_CLASSES);
+    key /= DEVICE_CLASSES;
+    s.returning = (int)(key % 2);
+    key /= 2;
+    s.known = (int)(key % MEMORIES);
+    key /= MEMORIES;
+    s.memory = (int)(key % MEMORIES);
+    s.position = (uint32_t)(key / MEMORIES);
+    return s;
+}
+
+// Sparse store of the blocks that carry mass
+struct Blocks {
+    uint64_t* keys;
+    float* cells;               // count * CELLS, [boredom][fear] per block; single precision
+                                // halves the memory the chain streams through
+    double* mass;               // per block: sum of its cells
+    double* held;               // count * SUBSETS: mass by the type bits claimed (R-20.1.2)
+    uint8_t* rows;              // per block: boredom rows in use; cells past them are stale
+    uint32_t count;
+    uint32_t capacity;
+};
+
+struct Chain {
+    const struct HouseMap* map;
+    uint32_t rooms;
+    int hunters;
+    int ghosts;
+    uint32_t* return_to;        // room a returning hunter walks to, MAP_NO_ROUTE = a random door
+
+    // Positions: position_of[r] is room r entered from nowhere (the start),
+    // followed by one per door of r in adjacency order
+    uint32_t positions;
+    uint32_t* position_of;
+    uint32_t* position_room;
+    uint32_t* position_prev;    // MAP_NO_ROUTE for the start position
+    uint32_t* entered_by;       // per adjacency entry r -> t: position (t, from r)
+
+    // Ghost type being followed
+    int emf_bit;                // type bit that is EMF, -1 for none
+    bool solves[SUBSETS];       // reported bits name the ghost
+
+    struct Blocks now;
+    struct Blocks next;
+    uint32_t* table;            // open addressing over next's keys: block index + 1, 0 = empty
+    uint32_t table_mask;
+    bool out_of_memory;
+
+    double* ghost;              // [room][boredom]
+    double* ghost_next;
+    double* evidence;           // [room][type bit]: probability the bit lies there
+    double* claimed;            // [room][type bit]: mass that claimed it this tick
+    double* kept;               // [room][type bit]: chance a bit outlived the other hunters' claims
+    double* unplaced;           // [room]: chance no haunt landed since the last hunter tick
+    double* unplaced_before;    // [room]: same for the hunter tick before that
+    double* occupancy;          // [room]: representative hunter's mass
+    double gone[SUBSETS];       // mass that left the house, by what it had claimed
+};
+
+static uint32_t room_degree(const struct HouseMap* map, uint32_t room) {
+    return map->adj_offset[room + 1] - map->adj_offset[room];
+}
+
+// ---- Block store ----
+static bool blocks_reserve(struct Blocks* b, uint32_t capacity) {
+    if (capacity <= b->capacity) return true;
+    uint32_t grown = b->capacity ? b->capacity : 256;
+    while (grown < capacity) grown *= 2;
+    uint64_t* keys = realloc(b->keys, grown * sizeof(*keys));
+    if (!keys) return false;
+    b->keys = keys;
+    float* cells = realloc(b->cells, (size_t)grown * CELLS * sizeof(*cells));
+    if (!cells) return false;
+    b->cells = cells;
+    double* mass = realloc(b->mass, grown * sizeof(*mass));
+    if (!mass) return false;
+    b->mass = mass;
+    double* held = realloc(b->held, (size_t)grown * SUBSETS * sizeof(*held));
+    if (!held) return false;
+    b->held = held;
+    uint8_t* rows = realloc(b->rows, grown * sizeof(*rows));
+    if (!rows) return false;
+    b->rows = rows;
+    b->capacity = grown;
+    return true;
+}
+
+static uint32_t table_home(const struct Chain* c, uint64_t key) {
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ull) >> 32) & c->table_mask;
+}
+
+// Table sized for next at half load; rebuilt from next's keys when it grows
+static bool table_fit(struct Chain* c, uint32_t blocks) {
+    if (c->table && (size_t)blocks * 2 <= (size_t)c->table_mask + 1) return true;
+    size_t size = c->table ? (size_t)c->table_mask + 1 : 1024;
+    while (size < (size_t)blocks * 2) size *= 2;
+    if (size > UINT32_MAX) return false;
+    uint32_t* table = calloc(size, sizeof(*table));
+    if (!table) return false;
+    free(c->table);
+    c->table = table;
+    c->table_mask = (uint32_t)(size - 1);
+    for (uint32_t i = 0; i < c->next.count; i++) {
+        uint32_t at = table_home(c, c->next.keys[i]);
+        while (c->table[at]) at = (at + 1) & c->table_mask;
+        c->table[at] = i + 1;
+    }
+    return true;
+}
+
+// Block of next to add weight * held into, created empty on first use; its
+// first rows boredom rows are valid afterwards, for the caller to add cells to
+static float* next_block(struct Chain* c, const struct BlockState* state, const double held[SUBSETS], double weight,
+                         int rows) {
+    uint64_t key = block_key(state);
+    uint32_t at = table_home(c, key);
+    while (c->table[at] && c->next.keys[c->table[at] - 1] != key) at = (at + 1) & c->table_mask;
+    uint32_t index;
+    if (c->table[at]) {
+        index = c->table[at] - 1;
+    } else {
+        index = c->next.count;
+        if (!blocks_reserve(&c->next, index + 1)) {
+            c->out_of_memory = true;
+            return NULL;
+        }
+        c->next.keys[index] = key;
+        c->next.mass[index] = 0.0;
+        memset(&c->next.held[(size_t)index * SUBSETS], 0, SUBSETS * sizeof(double));
+        c->next.rows[index] = 0;
+        c->next.count++;
+        if ((size_t)c->next.count * 2 > (size_t)c->table_mask + 1) {
+            if (!table_fit(c, c->next.count)) {
+                c->out_of_memory = true;
+                return NULL;
+            }
+        } else {
+            c->table[at] = index + 1;
+        }
+    }
+    float* cells = &c->next.cells[(size_t)index * CELLS];
+    if (c->next.rows[index] < rows) {
+        memset(cells + c->next.rows[index] * FEAR_STRIDE, 0, (size_t)(rows - c->next.rows[index]) * FEAR_STRIDE * sizeof(float));
+        c->next.rows[index] = (uint8_t)rows;
+    }
+    double* to = &c->next.held[(size_t)index * SUBSETS];
+    for (int set = 0; set < SUBSETS; set++) {
+        to[set] += held[set] * weight;
+        c->next.mass[index] += held[set] * weight;
+    }
+    return cells;
+}
+
+// next becomes the current distribution; light blocks forget what they
+// remember and the lightest are dropped
+static void chain_swap(struct Chain* c) {
+    uint32_t count = c->next.count;
+    for (uint32_t i = 0; i < count && !c->out_of_memory; i++) {
+        struct BlockState state = block_state(c->next.keys[i]);
+        if (c->next.mass[i] >= FORGETFUL || (state.memory == UNKNOWN && state.known == UNKNOWN)) continue;
+        state.memory = UNKNOWN;
+        state.known = UNKNOWN;
+        // next_block may move the arrays, so hold on to this block's split
+        double held[SUBSETS];
+        memcpy(held, &c->next.held[(size_t)i * SUBSETS], sizeof(held));
+        int rows = c->next.rows[i];
+        float* to = next_block(c, &state, held, 1.0, rows);
+        if (!to) break;
+        const float* from = &c->next.cells[(size_t)i * CELLS];
+        for (int j = 0; j < rows * FEAR_STRIDE; j++) to[j] += from[j];
+        c->next.mass[i] = 0.0;
+        memset(&c->next.held[(size_t)i * SUBSETS], 0, sizeof(held));
+    }
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < c->next.count; i++) {
+        if (c->next.mass[i] < NEGLIGIBLE) {
+            // Dropped blocks still count towards the case file with what they hold
+            for (int set = 0; set < SUBSETS; set++) c->gone[set] += c->next.held[(size_t)i * SUBSETS + set];
+            continue;
+        }
+        if (kept != i) {
+            c->next.keys[kept] = c->next.keys[i];
+            c->next.mass[kept] = c->next.mass[i];
+            c->next.rows[kept] = c->next.rows[i];
+            memcpy(&c->next.held[(size_t)kept * SUBSETS], &c->next.held[(size_t)i * SUBSETS], SUBSETS * sizeof(double));
+            memcpy(&c->next.cells[(size_t)kept * CELLS], &c->next.cells[(size_t)i * CELLS],
+                   (size_t)c->next.rows[i] * FEAR_STRIDE * sizeof(float));
+        }
+        kept++;
+    }
+    c->next.count = kept;
+
+    struct Blocks swap = c->now;
+    c->now = c->next;
+    c->next = swap;
+    c->next.count = 0;
+    memset(c->table, 0, ((size_t)c->table_mask + 1) * sizeof(*c->table));
+}
+
+// ---- Setup ----
+static bool chain_init(struct Chain* c, const struct EstimateConfig* config, const struct HouseMap* map) {
+    memset(c, 0, sizeof(*c));
+    c->map = map;
+    c->rooms = map->room_count;
+    c->hunters = config->hunter_count;
+    c->ghosts = config->ghost_count > 0 ? config->ghost_count : 1;
+    uint32_t doors = map->adj_offset[c->rooms];
+    if (doors > UINT32_MAX - c->rooms) return false;
+    c->positions = c->rooms + doors;
+
+    size_t ghost_states = (size_t)c->rooms * GHOST_BOREDOM_STATES;
+    c->return_to = calloc(c->rooms, sizeof(*c->return_to));
+    c->position_of = calloc(c->rooms, sizeof(*c->position_of));
+    c->position_room = calloc(c->positions, sizeof(*c->position_room));
+    c->position_prev = calloc(c->positions, sizeof(*c->position_prev));
+    c->entered_by = calloc((size_t)doors + 1, sizeof(*c->entered_by));
+    c->ghost = calloc(ghost_states, sizeof(double));
+    c->ghost_next = calloc(ghost_states, sizeof(double));
+    c->evidence = calloc((size_t)c->rooms * TYPE_BITS, sizeof(double));
+    c->claimed = calloc((size_t)c->rooms * TYPE_BITS, sizeof(double));
+    c->kept = calloc((size_t)c->rooms * TYPE_BITS, sizeof(double));
+    c->unplaced = calloc(c->rooms, sizeof(double));
+    c->unplaced_before = calloc(c->rooms, sizeof(double));
+    c->occupancy = calloc(c->rooms, sizeof(double));
+    if (!c->return_to || !c->position_of || !c->position_room || !c->position_prev || !c->entered_by ||
+        !c->ghost || !c->ghost_next || !c->evidence || !c->claimed || !c->kept || !c->unplaced ||
+        !c->unplaced_before || !c->occupancy || !blocks_reserve(&c->now, 256) || !blocks_reserve(&c->next, 256) ||
+        !table_fit(c, 256)) {
+        return false;
+    }
+
+    uint32_t position = 0;
+    for (uint32_t r = 0; r < c->rooms; r++) {
+        c->position_of[r] = position;
+        c->position_room[position] = r;
+        c->position_prev[position++] = MAP_NO_ROUTE;
+        for (uint32_t k = map->adj_offset[r]; k < map->adj_offset[r + 1]; k++) {
+            c->position_room[position] = r;
+            c->position_prev[position++] = map_adj(map, k);
+        }
+    }
+    for (uint32_t r = 0; r < c->rooms; r++) {
+        for (uint32_t k = map->adj_offset[r]; k < map->adj_offset[r + 1]; k++) {
+            uint32_t t = map_adj(map, k);
+            uint32_t back = map->adj_offset[t];
+            while (back < map->adj_offset[t + 1] && map_adj(map, back) != r) back++;
+            // A one-way door (hand-made maps) leaves the hunter without a way back
+            c->entered_by[k] = back < map->adj_offset[t + 1] ? c->position_of[t] + 1 + (back - map->adj_offset[t])
+                                                              : c->position_of[t];
+        }
+    }
+
+    // hunter_tick's choice for a returning hunter: the exit route, else an
+    // adjacent exit, else a random door
+    for (uint32_t r = 0; r < c->rooms; r++) {
+        uint32_t target = config->random_return ? MAP_NO_ROUTE : map->exit_hop[r];
+        for (uint32_t k = map->adj_offset[r]; target == MAP_NO_ROUTE && k < map->adj_offset[r + 1]; k++) {
+            if (map->is_exit[map_adj(map, k)]) target = map_adj(map, k);
+        }
+        c->return_to[r] = target;
+    }
+    return true;
+}
+
+static void chain_free(struct Chain* c) {
+    free(c->return_to);
+    free(c->position_of);
+    free(c->position_room);
+    free(c->position_prev);
+    free(c->entered_by);
+    free(c->now.keys);
+    free(c->now.cells);
+    free(c->now.mass);
+    free(c->now.held);
+    free(c->now.rows);
+    free(c->next.keys);
+    free(c->next.cells);
+    free(c->next.mass);
+    free(c->next.held);
+    free(c->next.rows);
+    free(c->table);
+    free(c->ghost);
+    free(c->ghost_next);
+    free(c->evidence);
+    free(c->claimed);
+    free(c->kept);
+    free(c->unplaced);
+    free(c->unplaced_before);
+    free(c->occupancy);
+}
+
+// Chance of each device class when a device is drawn at random (R-16.3, R-18.3)
+static double device_weight(int device) {
+    return device == BLIND ? (double)(DEVICE_COUNT - TYPE_BITS) / DEVICE_COUNT : 1.0 / DEVICE_COUNT;
+}
+
+// Fresh game: hunters in the start room holding a random device, ghosts in a
+// random room. Only which bit is EMF and which reports solve the case tell
+// ghost types apart here.
+static void chain_start(struct Chain* c, int emf_bit, const bool solves[SUBSETS]) {
+    c->emf_bit = emf_bit;
+    memcpy(c->solves, solves, sizeof(c->solves));
+
+    c->now.count = 0;
+    c->next.count = 0;
+    for (int device = 0; device < DEVICE_CLASSES; device++) {
+        struct BlockState start = { c->position_of[c->map->start_room], UNKNOWN, UNKNOWN, 0, device };
+        double empty_handed[SUBSETS] = { device_weight(device) };
+        float* cells = next_block(c, &start, empty_handed, 1.0, 1);
+        if (cells) cells[0] = (float)device_weight(device);
+    }
+    chain_swap(c);
+
+    memset(c->ghost, 0, (size_t)c->rooms * GHOST_BOREDOM_STATES * sizeof(double));
+    for (uint32_t r = 0; r < c->rooms; r++) {
+        c->ghost[r * GHOST_BOREDOM_STATES] = 1.0 / c->rooms;
+        c->unplaced[r] = 1.0;
+        c->unplaced_before[r] = 1.0;
+        c->occupancy[r] = 0.0;
+    }
+    c->occupancy[c->map->start_room] = 1.0;
+    memset(c->evidence, 0, (size_t)c->rooms * TYPE_BITS * sizeof(double));
+    for (size_t i = 0; i < (size_t)c->rooms * TYPE_BITS; i++) c->kept[i] = 1.0;
+    memset(c->gone, 0, sizeof(c->gone));
+}
+
+// ---- Ghost tick (ghost_tick) ----
+static void chain_ghost_tick(struct Chain* c, int loop_count) {
+    const struct HouseMap* map = c->map;
+    memset(c->ghost_next, 0, (size_t)c->rooms * GHOST_BOREDOM_STATES * sizeof(double));
+
+    for (uint32_t r = 0; r < c->rooms; r++) {
+        // Chance that none of the hunters stands in the room
+        double alone = pow(1.0 - fmin(c->occupancy[r], 1.0), c->hunters);
+
+        uint32_t degree = room_degree(map, r);
+        double haunting = 0.0;
+        for (int bo = 0; bo < ENTITY_BOREDOM_MAX; bo++) {
+            double mass = c->ghost[r * GHOST_BOREDOM_STATES + bo];
+            if (mass == 0.0) continue;
+            for (int present = 0; present <= 1; present++) {
+                double share = mass * (present ? 1.0 - alone : alone);
+                int boredom = present ? 0 : bo + 1;
+                // Bored out once the hunters had time to explore
+                if (share == 0.0 || (boredom >= ENTITY_BOREDOM_MAX && loop_count > 50)) continue;
+
+                // Idle, haunt or move, a third each; hunters keep it in place
+                haunting += share / 3.0;
+                if (present || degree == 0) {
+                    c->ghost_next[r * GHOST_BOREDOM_STATES + boredom] += share;
+                    continue;
+                }
+                c->ghost_next[r * GHOST_BOREDOM_STATES + boredom] += share * 2.0 / 3.0;
+                for (uint32_t k = map->adj_offset[r]; k < map->adj_offset[r + 1]; k++) {
+                    c->ghost_next[map_adj(map, k) * GHOST_BOREDOM_STATES + boredom] += share / 3.0 / degree;
+                }
+            }
+        }
+
+        // A haunt picks one of the seven bits; those outside the type are lost
+        double untouched = pow(1.0 - haunting / DEVICE_COUNT, c->ghosts);
+        c->unplaced[r] *= untouched;
+        for (int k = 0; k < TYPE_BITS; k++) {
+            double* bit = &c->evidence[r * TYPE_BITS + (uint32_t)k];
+            *bit = 1.0 - (1.0 - *bit) * untouched;
+        }
+    }
+
+    double* swap = c->ghost;
+    c->ghost = c->ghost_next;
+    c->ghost_next = swap;
+}
+
+// ---- Hunter tick (hunter_tick) ----
+// Chance of each set of type bits lying in room r, from the room's marginals
+// or, when the hunter was here two ticks ago, from the set it left behind
+static void room_contents(const struct Chain* c, uint32_t r, int known, double contents[SUBSETS]) {
+    double present[TYPE_BITS];
+    double fresh = 1.0 - c->unplaced[r] * c->unplaced_before[r];
+    for (int k = 0; k < TYPE_BITS; k++) {
+        double kept = c->kept[r * TYPE_BITS + (uint32_t)k];
+        if (known == UNKNOWN) {
+            present[k] = c->evidence[r * TYPE_BITS + (uint32_t)k];
+        } else if (known & (1 << k)) {
+            present[k] = kept + (1.0 - kept) * fresh;
+        } else {
+            present[k] = fresh;
+        }
+    }
+    for (int set = 0; set < SUBSETS; set++) {
+        double p = 1.0;
+        for (int k = 0; k < TYPE_BITS; k++) {
+            p *= (set & (1 << k)) ? present[k] : 1.0 - present[k];
+        }
+        contents[set] = p;
+    }
+}
+
+struct TickExits {
+    double bored;
+    double afraid;
+};
+
+// One block after R-17..R-20, before moving. A claim only moves mass
+// between entries of held, so found and not found share an outcome.
+struct Outcome {
+    float cells[CELLS];
+    double held[SUBSETS];
+    double mass;
+    int rows;                   // boredom rows written so far
+    bool used;
+};
+
+// Outcomes split by the device in hand, the set left in the room and the
+// returning flag
+struct Moved {
+    struct Outcome out[DEVICE_CLASSES][SUBSETS][2];
+};
+
+// Make the first rows boredom rows of an outcome valid
+static void outcome_rows(struct Outcome* o, int rows) {
+    if (o->rows >= rows) return;
+    memset(o->cells + o->rows * FEAR_STRIDE, 0, (size_t)(rows - o->rows) * FEAR_STRIDE * sizeof(float));
+    o->rows = rows;
+}
+
+// R-17 and R-19 for one outcome, scaled by p, into the returning and staying
+// halves of a moved block; returns the mass that stays in the house, which
+// goes to the halves as heads_back and 1 - heads_back. Seeing evidence resets
+// boredom, so only the first row of the halves is written then.
+static double apply_stats(const float* restrict cells, int rows, const double* restrict by_fear, double p, int seen,
+                          int emf, double heads_back, struct Outcome* back, struct Outcome* stay,
+                          struct TickExits* exits) {
+    double to_back = p * heads_back;
+    double to_stay = p - to_back;
+    double kept = 0.0;
+    if (seen) {
+        // R-17: evidence resets boredom and raises fear, more for EMF
+        int raise = 1 + emf;
+        outcome_rows(back, 1);
+        outcome_rows(stay, 1);
+        for (int fe = 0; fe + raise < FEAR_STATES; fe++) {
+            back->cells[fe + raise] += by_fear[fe] * to_back;
+            stay->cells[fe + raise] += by_fear[fe] * to_stay;
+            kept += by_fear[fe];
+        }
+        for (int fe = FEAR_STATES - raise; fe < FEAR_STATES; fe++) exits->afraid += by_fear[fe] * p;
+        return kept * p;
+    }
+    // Nothing here: one more tick of boredom, which R-19 checks first
+    int shifted = rows < BOREDOM_STATES ? rows : BOREDOM_STATES - 1;
+    if (rows == BOREDOM_STATES) {
+        for (int fe = 0; fe < FEAR_STATES; fe++) {
+            exits->bored += cells[(BOREDOM_STATES - 1) * FEAR_STRIDE + fe] * p;
+        }
+    }
+    outcome_rows(back, shifted + 1);
+    outcome_rows(stay, shifted + 1);
+    for (int i = 0; i < shifted * FEAR_STRIDE; i++) {
+        back->cells[i + FEAR_STRIDE] += cells[i] * to_back;
+        stay->cells[i + FEAR_STRIDE] += cells[i] * to_stay;
+        kept += cells[i];
+    }
+    return kept * p;
+}
+
+static void add_cells(float* restrict to, const float* restrict from, int rows, float weight) {
+    for (int i = 0; i < rows * FEAR_STRIDE; i++) to[i] += from[i] * weight;
+}
+
+// Movement: returning hunters follow return_to, the rest take a random door;
+// reaching an exit ends a return trip. from is the block before R-17..R-20.
+static void move_block(struct Chain* c, const struct BlockState* from, struct BlockState moved,
+                       const struct Outcome* o) {
+    const struct HouseMap* map = c->map;
+    uint32_t r = c->position_room[from->position];
+    uint32_t came_from = c->position_prev[from->position];
+    if (o->mass < NEGLIGIBLE) return;
+
+    uint32_t first = map->adj_offset[r], last = map->adj_offset[r + 1];
+    if (first == last) {
+        // Nowhere to go: the room just left is this one
+        moved.position = c->position_of[r];
+        moved.known = moved.memory;
+        moved.memory = UNKNOWN;
+        float* to = next_block(c, &moved, o->held, 1.0, o->rows);
+        if (!to) return;
+        add_cells(to, o->cells, o->rows, 1.0f);
+        c->occupancy[r] += o->mass;
+        return;
+    }
+    if (moved.returning && c->return_to[r] != MAP_NO_ROUTE) {
+        while (map_adj(map, first) != c->return_to[r]) first++;
+        last = first + 1;
+    }
+    bool returning = moved.returning;
+    double weight = 1.0 / (last - first);
+    for (uint32_t k = first; k < last; k++) {
+        uint32_t t = map_adj(map, k);
+        struct BlockState to_state = moved;
+        to_state.position = c->entered_by[k];
+        to_state.known = t == came_from ? from->memory : UNKNOWN;
+        to_state.returning = returning && !map->is_exit[t];
+        float* to = next_block(c, &to_state, o->held, weight, o->rows);
+        if (!to) return;
+        add_cells(to, o->cells, o->rows, (float)weight);
+        c->occupancy[t] += o->mass * weight;
+    }
+}
+
+// R-17..R-20 and the move for one block of the current distribution
+static void block_tick(struct Chain* c, uint32_t index, struct Moved* moved, struct TickExits* exits) {
+    struct BlockState state = block_state(c->now.keys[index]);
+    const float* cells = &c->now.cells[(size_t)index * CELLS];
+    const double* held = &c->now.held[(size_t)index * SUBSETS];
+    int rows = c->now.rows[index];
+    uint32_t r = c->position_room[state.position];
+    bool at_exit = c->map->is_exit[r];
+
+    double by_fear[FEAR_STRIDE] = { 0.0 };
+    double mass = 0.0;
+    for (int bo = 0; bo < rows; bo++) {
+        for (int fe = 0; fe < FEAR_STRIDE; fe++) by_fear[fe] += cells[bo * FEAR_STRIDE + fe];
+    }
+    for (int fe = 0; fe < FEAR_STATES; fe++) mass += by_fear[fe];
+    if (mass < NEGLIGIBLE) return;
+
+    double contents[SUBSETS];
+    room_contents(c, r, state.known, contents);
+    struct TickExits left_house = { 0.0, 0.0 };
+
+    // R-18.3: the van hands out a random device
+    int first = at_exit ? 0 : state.device;
+    int last = at_exit ? DEVICE_CLASSES - 1 : state.device;
+    for (int d = first; d <= last; d++) {
+        for (int left = 0; left < SUBSETS; left++) {
+            moved->out[d][left][0].used = false;
+            moved->out[d][left][1].used = false;
+        }
+    }
+    for (int d = first; d <= last; d++) {
+        double weight = at_exit ? device_weight(d) : 1.0;
+        for (int set = 0; set < SUBSETS; set++) {
+            double p = weight * contents[set];
+            if (p == 0.0) continue;
+            int seen = set != 0;
+            int emf = c->emf_bit >= 0 && (set & (1 << c->emf_bit));
+            int found = d != BLIND && (set & (1 << d));
+            int left = found ? set & ~(1 << d) : set;
+
+            // R-20: a claim sends the hunter back unless it stands at an exit;
+            // otherwise maybe head back for another device
+            double heads_back;
+            int back_flag = 1, stay_flag = 0;
+            if (found) {
+                heads_back = 1.0;
+                back_flag = state.returning || !at_exit;
+                stay_flag = back_flag;
+            } else {
+                heads_back = state.returning ? 1.0
+                                             : 1.0 - (1.0 - RETURN_CHANCE) * (seen ? 1.0 - SWAP_CHANCE : 1.0);
+            }
+            for (int flag = 0; flag <= 1; flag++) {
+                struct Outcome* o = &moved->out[d][left][flag];
+                if (!o->used) {
+                    memset(o->held, 0, sizeof(o->held));
+                    o->mass = 0.0;
+                    o->rows = 0;
+                    o->used = true;
+                }
+            }
+            struct Outcome* back = &moved->out[d][left][back_flag];
+            struct Outcome* stay = &moved->out[d][left][stay_flag];
+            double stays = apply_stats(cells, rows, by_fear, p, seen, emf, heads_back, back, stay, &left_house);
+            back->mass += stays * heads_back;
+            stay->mass += stays * (1.0 - heads_back);
+            // R-20.1.2: the claimed set grows by the bit found
+            double share = stays / mass;
+            int claim = found ? 1 << d : 0;
+            for (int had = 0; had < SUBSETS; had++) {
+                back->held[had | claim] += held[had] * share * heads_back;
+                stay->held[had | claim] += held[had] * share * (1.0 - heads_back);
+            }
+            if (found) c->claimed[r * TYPE_BITS + (uint32_t)d] += stays;
+        }
+    }
+    exits->bored += left_house.bored;
+    exits->afraid += left_house.afraid;
+    double leaving = (left_house.bored + left_house.afraid) / mass;
+    for (int had = 0; had < SUBSETS; had++) c->gone[had] += held[had] * leaving;
+
+    for (int d = first; d <= last; d++) {
+        for (int left = 0; left < SUBSETS; left++) {
+            for (int flag = 0; flag <= 1; flag++) {
+                if (!moved->out[d][left][flag].used) continue;
+                struct BlockState after = state;
+                after.memory = left;
+                after.returning = flag;
+                after.device = d;
+                move_block(c, &state, after, &moved->out[d][left][flag]);
+            }
+        }
+    }
+}
+
+// Chance the case is still open. The case file holds the union of what the N
+// hunters collected, inside the house or gone; with the hunters independent,
+// the union lies within a set T with the N-th power of the chance that one
+// hunter's collection does, and inclusion-exclusion gives each exact union.
+static double case_open(const struct Chain* c) {
+    double held[SUBSETS];
+    double total = 0.0;
+    memcpy(held, c->gone, sizeof(held));
+    for (uint32_t i = 0; i < c->now.count; i++) {
+        for (int set = 0; set < SUBSETS; set++) held[set] += c->now.held[(size_t)i * SUBSETS + set];
+    }
+    for (int set = 0; set < SUBSETS; set++) total += held[set];
+    held[0] += fmax(0.0, 1.0 - total);           // dropped as negligible, most likely empty-handed
+
+    double within[SUBSETS];
+    for (int t = 0; t < SUBSETS; t++) {
+        double one = 0.0;
+        for (int set = 0; set < SUBSETS; set++) {
+            if ((set & ~t) == 0) one += held[set];
+        }
+        within[t] = pow(fmin(one, 1.0), c->hunters);
+    }
+    double open = 0.0;
+    for (int u = 0; u < SUBSETS; u++) {
+        if (c->solves[u]) continue;
+        for (int t = 0; t < SUBSETS; t++) {
+            if ((t & ~u) != 0) continue;
+            open += (__builtin_popcount((unsigned)(u & ~t)) & 1) ? -within[t] : within[t];
+        }
+    }
+    return fmin(fmax(open, 0.0), 1.0);
+}
+
+// One hunter tick; returns the chance the case is still open afterwards
+static double chain_hunter_tick(struct Chain* c, struct Moved* moved, struct TickExits* exits) {
+    memset(c->claimed, 0, (size_t)c->rooms * TYPE_BITS * sizeof(double));
+    memset(c->occupancy, 0, c->rooms * sizeof(double));
+    exits->bored = 0.0;
+    exits->afraid = 0.0;
+    for (uint32_t i = 0; i < c->now.count; i++) {
+        block_tick(c, i, moved, exits);
+    }
+    chain_swap(c);
+
+    // Claims clear the room (any of the N hunters may be the one); kept is
+    // how much of a hunter's own memory of the room survives the others
+    for (uint32_t r = 0; r < c->rooms; r++) {
+        for (int k = 0; k < TYPE_BITS; k++) {
+            double claimed = c->claimed[r * TYPE_BITS + (uint32_t)k];
+            double* bit = &c->evidence[r * TYPE_BITS + (uint32_t)k];
+            double share = *bit > 0.0 ? fmin(claimed / *bit, 1.0) : 0.0;
+            *bit *= pow(1.0 - share, c->hunters);
+            c->kept[r * TYPE_BITS + (uint32_t)k] = pow(1.0 - share, c->hunters - 1);
+        }
+        c->unplaced_before[r] = c->unplaced[r];
+        c->unplaced[r] = 1.0;
+    }
+    return case_open(c);
+}
+
+static double hunter_mass(const struct Chain* c) {
+    double total = 0.0;
+    for (uint32_t r = 0; r < c->rooms; r++) total += c->occupancy[r];
+    return total;
+}
+
+// ---- Game ----
+// Follow one ghost type until every hunter has left
+static int chain_play(struct Chain* c, struct Moved* moved, struct GhostEstimate* out) {
+    int n = c->hunters;
+    double alive = 1.0;          // representative hunter still inside
+    double anyone = 1.0;         // at least one of the N inside
+    double open = 1.0;           // case not yet solved
+    double won = 0.0, won_ms = 0.0;
+    double lost = 0.0, lost_ms = 0.0;
+    double exits[3] = { 0.0, 0.0, 0.0 };
+
+    int step = 0;
+    for (int tick = 0; tick < MAX_HUNTER_TICKS && anyone > SETTLED && !c->out_of_memory; step++) {
+        if (step % GHOST_STEPS == 0) chain_ghost_tick(c, step / GHOST_STEPS + 1);
+        if (step % HUNTER_STEPS != 0) continue;
+
+        struct TickExits tick_exits;
+        double still_open = chain_hunter_tick(c, moved, &tick_exits);
+        double still_alive = hunter_mass(c);
+        double still_anyone = 1.0 - pow(1.0 - fmin(still_alive, 1.0), n);
+        double at_ms = (double)tick * HUNTER_TICK_MS;
+
+        // A solve ends the game now for the hunters after the solver and on
+        // the next tick for those before it
+        double solved = open - still_open;
+        double team = anyone > 0.0 ? n * alive / anyone : 1.0;
+        won += solved;
+        won_ms += solved * (at_ms + HUNTER_TICK_MS * (1.0 - 1.0 / fmax(team, 1.0)));
+        lost += still_open * (anyone - still_anyone);
+        lost_ms += still_open * (anyone - still_anyone) * at_ms;
+        exits[LR_BORED] += open * tick_exits.bored;
+        exits[LR_AFRAID] += open * tick_exits.afraid;
+
+        alive = still_alive;
+        anyone = still_anyone;
+        open = still_open;
+        tick++;
+    }
+
+    out->win = won;
+    out->solve_ms = won > 0.0 ? won_ms / won : 0.0;
+    out->length_ms = won + lost > 0.0 ? (won_ms + lost_ms) / (won + lost) : 0.0;
+    out->exits[LR_BORED] = exits[LR_BORED];
+    out->exits[LR_AFRAID] = exits[LR_AFRAID];
+    out->exits[LR_EVIDENCE] = fmax(0.0, 1.0 - exits[LR_BORED] - exits[LR_AFRAID]);
+    return step;
+}
+
+// What the chain sees of a ghost type: which of its bits is EMF and which
+// sets of them name it
+static void type_shape(enum GhostType type, int* emf_bit, bool solves[SUBSETS]) {
+    EvidenceByte bits[TYPE_BITS] = { 0 };
+    int found = 0;
+    for (int i = 0; i < 8 && found < TYPE_BITS; i++) {
+        if ((EvidenceByte)type & (1u << i)) bits[found++] = (EvidenceByte)(1u << i);
+    }
+    *emf_bit = -1;
+    for (int k = 0; k < TYPE_BITS; k++) {
+        if (bits[k] == EV_EMF) *emf_bit = k;
+    }
+    for (int set = 0; set < SUBSETS; set++) {
+        EvidenceByte mask = 0;
+        for (int k = 0; k < TYPE_BITS; k++) {
+            if (set & (1 << k)) mask |= bits[k];
+        }
+        solves[set] = evidence_deduce(mask)->candidate_count == 1;
+    }
+}
+
+bool estimate_run(const struct EstimateConfig* config, struct Estimate* estimate) {
+    memset(estimate, 0, sizeof(*estimate));
+    const struct HouseMap* map = config->map ? config->map : map_willow();
+    if (!map || config->hunter_count < 1) return false;
+
+    struct Chain chain;
+    struct Moved* moved = malloc(sizeof(*moved));
+    bool ok = chain_init(&chain, config, map) && moved;
+    estimate->hunter_count = chain.hunters;
+    estimate->ghost_count = chain.ghosts;
+
+    // Types of the same shape share one chain
+    const enum GhostType* ghost_types = NULL;
+    int type_count = get_all_ghost_types(&ghost_types);
+    if (type_count > GHOST_TYPE_COUNT) type_count = GHOST_TYPE_COUNT;
+    int emf_bits[GHOST_TYPE_COUNT];
+    bool solves[GHOST_TYPE_COUNT][SUBSETS];
+    for (int g = 0; ok && g < type_count; g++) {
+        type_shape(ghost_types[g], &emf_bits[g], solves[g]);
+        int same = 0;
+        while (same < g && (emf_bits[same] != emf_bits[g] || memcmp(solves[same], solves[g], sizeof(solves[g])))) {
+            same++;
+        }
+        if (same < g) {
+            estimate->by_ghost[g] = estimate->by_ghost[same];
+        } else {
+            chain_start(&chain, emf_bits[g], solves[g]);
+            int steps = chain_play(&chain, moved, &estimate->by_ghost[g]);
+            if (steps > estimate->steps) estimate->steps = steps;
+            ok = !chain.out_of_memory;
+        }
+        estimate->win += estimate->by_ghost[g].win / type_count;
+        estimate->length_ms += estimate->by_ghost[g].length_ms / type_count;
+    }
+    chain_free(&chain);
+    free(moved);
+    return ok;
+}
+
+// ---- Output ----
+void estimate_print(const struct Estimate* estimate, const struct BatchStats* monte_carlo) {
+    const enum GhostType* ghost_types = NULL;
+    int type_count = get_all_ghost_types(&ghost_types);
+
+    printf("\n=== MARKOV ESTIMATE ===\n");
+    printf("Hunters per run: %d  Ghosts per run: %d  Chain length: %d steps of %d ms\n",
+           estimate->hunter_count, estimate->ghost_count, estimate->steps, STEP_MS);
+    printf("Win rate: %.1f%%  Mean game length: %.1f s\n", 100.0 * estimate->win, estimate->length_ms / 1000.0);
+    if (monte_carlo && monte_carlo->runs > 0) {
+        printf("Played: win rate %.1f%%, mean game length %.1f s over %ld runs\n",
+               100.0 * monte_carlo->wins / monte_carlo->runs,
+               (double)monte_carlo->total_duration_ms / monte_carlo->runs / 1000.0, monte_carlo->runs);
+    }
+
+    if (!monte_carlo) {
+        printf("\n%-12s %7s %10s %10s %9s %7s %7s\n", "ghost", "win%", "solve(s)", "length(s)", "evidence", "bored", "afraid");
+        for (int g = 0; g < type_count && g < GHOST_TYPE_COUNT; g++) {
+            const struct GhostEstimate* e = &estimate->by_ghost[g];
+            printf("%-12s %6.1f%% %10.1f %10.1f %8.1f%% %6.1f%% %6.1f%%\n",
+                   ghost_to_string(ghost_types[g]), 100.0 * e->win, e->solve_ms / 1000.0, e->length_ms / 1000.0,
+                   100.0 * e->exits[LR_EVIDENCE], 100.0 * e->exits[LR_BORED], 100.0 * e->exits[LR_AFRAID]);
+        }
+        return;
+    }
+
+    // Side by side; the played win rate carries its binomial standard error
+    printf("\n%-12s %8s %7s %7s %6s %10s %9s %9s %9s\n",
+           "ghost", "runs", "win%", "played", "+-", "gap(pp)", "length(s)", "played", "bored%");
+    double worst_gap = 0.0, gap_total = 0.0, worst_length = 0.0;
+    int compared = 0;
+    for (int g = 0; g < type_count && g < GHOST_TYPE_COUNT; g++) {
+        const struct GhostEstimate* e = &estimate->by_ghost[g];
+        const struct GhostTypeStats* played = &monte_carlo->by_ghost[g];
+        if (played->runs == 0) continue;
+        double rate = (double)played->wins / played->runs;
+        double error = sqrt(rate * (1.0 - rate) / played->runs);
+        double length = (double)played->duration_ms_total / played->runs;
+        long exits = played->exit_counts[0] + played->exit_counts[1] + played->exit_counts[2];
+        double gap = 100.0 * (e->win - rate);
+        printf("%-12s %8ld %6.1f%% %6.1f%% %6.1f %+10.1f %9.2f %9.2f %4.0f/%-4.0f\n",
+               ghost_to_string(ghost_types[g]), played->runs, 100.0 * e->win, 100.0 * rate, 100.0 * error, gap,
+               e->length_ms / 1000.0, length / 1000.0, 100.0 * e->exits[LR_BORED],
+               exits ? 100.0 * played->exit_counts[LR_BORED] / exits : 0.0);
+        if (fabs(gap) > worst_gap) worst_gap = fabs(gap);
+        if (fabs(e->length_ms - length) > worst_length) worst_length = fabs(e->length_ms - length);
+        gap_total += fabs(gap);
+        compared++;
+    }
+    if (compared > 0) {
+        printf("Win-rate gap: mean %.1f pp, worst %.1f pp; worst length gap %.2f s\n",
+               gap_total / compared, worst_gap, worst_length / 1000.0);
+    }
+}
@@ -0,0 +1,81 @@
+#ifndef ESTIMATE_H
+#define ESTIMATE_H
+
+#include "runner.h"
+#include "map.h"
+#include <stdbool.h>
+
+// Win probability and game length per ghost type, computed from a Markov
+// chain instead of by playing games.
+//
+// The exact game state (every hunter, the ghost and seven evidence bits in
+// every room) is far too large to enumerate, so the chain is aggregated. One
+// representative hunter is followed exactly over its room, the room it came
+// from, boredom, fear, device, the returning flag and what it left in the
+// rooms one step behind it. The type bits it has claimed never change its
+// moves, so each of those states carries its mass split by claimed set
+// instead of multiplying the state count by eight. The ghost is
+// followed over (room, boredom). Between them, each room only carries the
+// probability that each of the ghost's evidence bits is lying there. The N
+// hunters and G ghosts are treated as independent copies that meet through
+// those room probabilities. The case file is the union of what the N hunters
+// claimed.
+//
+// Time advances in the event engine's 100 ms steps: ghosts tick before
+// hunters at equal times, and every R-17..R-20 and ghost rule is applied
+// with its real probabilities. A hunter's boredom and fear bound its life to
+// ENTITY_BOREDOM_MAX * HUNTER_FEAR_MAX ticks, so the chain ends after a
+// fixed number of steps at most.
+//
+// What the aggregation gives up:
+// - correlations between hunters, who in play share one ghost and one
+//   layout of evidence and so tend to leave together (the estimated game
+//   length runs long);
+// - evidence bits in one room being placed together;
+// - the order in which hunters claim within one tick;
+// - room capacity, which is assumed never to be reached.
+// Use estimate_print with a Monte Carlo batch to see how far off that is.
+// Only the shared case file is modelled.
+
+// Chain results for one ghost type
+struct GhostEstimate {
+    double win;            // probability the case is solved
+    double solve_ms;       // mean length of the games that are won
+    double length_ms;      // mean game length
+    double exits[3];       // share of hunter exits, indexed by enum LogReason
+};
+
+struct Estimate {
+    int hunter_count;
+    int ghost_count;
+    double win;            // over ghost types drawn uniformly, as sim_setup_ghosts does
+    double length_ms;
+    int steps;             // longest chain followed, in 100 ms steps
+    struct GhostEstimate by_ghost[GHOST_TYPE_COUNT];
+};
+
+// What to estimate; mirrors the RunnerConfig fields the chain models
+struct EstimateConfig {
+    const struct HouseMap* map;   // NULL = Willow
+    int hunter_count;
+    int ghost_count;              // 0 = 1
+    bool random_return;
+};
+
+/**
+ * @brief Build and run the chain for every ghost type.
+ * @param[in] config House, team and rule switches.
+ * @param[out] estimate Per-type and overall results.
+ * @return false when the map cannot be loaded or memory runs out.
+ */
+bool estimate_run(const struct EstimateConfig* config, struct Estimate* estimate);
+
+/**
+ * @brief Print the estimate as a per-ghost table, side by side with a Monte
+ *        Carlo batch of the same game when one is given.
+ * @param[in] estimate Result of estimate_run.
+ * @param[in] monte_carlo Batch to validate against, or NULL.
+ */
+void estimate_print(const struct Estimate* estimate, const struct BatchStats* monte_carlo);
+
+#endif // ESTIMATE_H
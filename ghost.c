@@ -1,74 +1,110 @@
 #include "defs.h"
 #include "helpers.h"
+#include "logger.h"
 #include <stdlib.h>
 #include <unistd.h>
 #include <time.h>
 #include <pthread.h>
 
-void* ghost_thread_fn(void* arg) {
-    struct Ghost* g = (struct Ghost*)arg;
-    if (!g || !g->current_room) return NULL;
-
-    srand(time(NULL) ^ g->id);
-    g->running = true;
+void ghost_start(struct Ghost* g) {
+    g->boredom = 0;
+    g->loop_count = 0;
     log_ghost_init(g->id, g->current_room->name, g->type);
+}
+
+bool ghost_tick(struct Ghost* g) {
+    if (g->boredom >= ENTITY_BOREDOM_MAX || !atomic_load(&g->running)) {
+        return false;
+    }
+
+    // Identified: nothing left to haunt for
+    struct House* house = g->current_room->house;
+    if (!house->private_evidence && casefile_is_solved(&house->casefile)) {
+        log_ghost_exit(g->id, g->boredom, g->current_room->name);
+        atomic_store(&g->running, false);
+        return false;
+    }
+
+    g->loop_count++;
+
+    // Check for hunters in room
+    bool hunters_present = room_has_hunters(g->current_room);
+    if (hunters_present) {
+        g->boredom = 0; // Ghost stays to scare hunters
+    } else {
+        g->boredom++;
+    }
+
+    // Exit if bored (but not too early - give hunters time to explore)
+    if (g->boredom >= ENTITY_BOREDOM_MAX && g->loop_count > 50) {
+        log_ghost_exit(g->id, g->boredom, g->current_room->name);
+        atomic_store(&g->running, false);
+        return false;
+    }
 
-    int boredom = 0;
-    int loop_count = 0;
+    // Random action: idle, haunt, move
+    int action = rng_range(&g->rng, 0, 3); // 0=idle, 1=haunt, 2=move
 
-    while (boredom < ENTITY_BOREDOM_MAX && g->running) {
-        loop_count++;
-        
-        // Check for hunters in room
-        bool hunters_present = room_has_hunters(g->current_room);
-        if (hunters_present) {
-            boredom = 0; // Ghost stays to scare hunters
+    if (action == 0) {
+        log_ghost_idle(g->id, g->boredom, g->current_room->name);
+    } else if (action == 1) { // Haunt / place evidence
+        EvidenceByte evidence_options = g->type;
+        EvidenceByte placed = 1 << rng_range(&g->rng, 0, 7);
+        placed &= evidence_options;
+        if (placed) {
+            room_place_evidence(g->current_room, placed);
+            log_ghost_evidence(g->id, g->boredom, g->current_room->name, placed);
+
+            // EMF evidence gives hunters immediate fear reaction
+            if (placed == EV_EMF && room_has_hunters(g->current_room)) {
+                // Hunter will react to this on their next loop
+            }
+        }
+    } else if (action == 2 && g->current_room->conn_count > 0) { // Move
+        // Ghost cannot move if hunters are present (they want to scare them)
+        if (!hunters_present) {
+            int idx = rng_range(&g->rng, 0, g->current_room->conn_count);
+            struct Room* old = g->current_room;
+            g->current_room = room_neighbor(g->current_room, idx);
+            log_ghost_move(g->id, g->boredom, old->name, g->current_room->name);
         } else {
-            boredom++;
+            // Ghost stays put to scare hunters
+            log_ghost_idle(g->id, g->boredom, g->current_room->name);
         }
+    }
 
-        // Exit if bored (but not too early - give hunters time to explore)
-        if (boredom >= ENTITY_BOREDOM_MAX && loop_count > 50) {
-            log_ghost_exit(g->id, boredom, g->current_room->name);
-            g->running = false;
-            break;
-        }
+    return true;
+}
+
+void* ghost_thread_fn(void* arg) {
+    struct Ghost* g = (struct Ghost*)arg;
+    if (!g || !g->current_room) return NULL;
 
-        // Random action: idle, haunt, move
-        int action = rand_int_threadsafe(0, 3); // 0=idle, 1=haunt, 2=move
+    struct House* house = g->current_room->house;
+    logger_set_run(house->log_run);
+    ghost_start(g);
+    simclock_schedule_start(&g->schedule, GHOST_TICK_MS);
+    for (;;) {
+        // Snapshot before the tick reads the room, so a signal that lands
+        // while it runs still wakes the wait below
+        struct Room* room = g->current_room;
+        unsigned seen = house->reactive ? room_signal_seen(room, ROOM_SIGNAL_ARRIVAL) : 0;
+        if (!ghost_tick(g)) break;
 
-        if (action == 0) {
-            log_ghost_idle(g->id, boredom, g->current_room->name);
-        } else if (action == 1) { // Haunt / place evidence
-            EvidenceByte evidence_options = g->type;
-            EvidenceByte placed = 1 << rand_int_threadsafe(0, 7);
-            placed &= evidence_options;
-            if (placed) {
-                pthread_mutex_lock(&g->current_room->mutex);
-                g->current_room->evidence_here |= placed;
-                pthread_mutex_unlock(&g->current_room->mutex);
-                log_ghost_evidence(g->id, boredom, g->current_room->name, placed);
-                
-                // EMF evidence gives hunters immediate fear reaction
-                if (placed == EV_EMF && room_has_hunters(g->current_room)) {
-                    // Hunter will react to this on their next loop
-                }
-            }
-        } else if (action == 2 && g->current_room->conn_count > 0) { // Move
-            // Ghost cannot move if hunters are present (they want to scare them)
-            if (!hunters_present) {
-                int idx = rand_int_threadsafe(0, g->current_room->conn_count);
-                struct Room* old = g->current_room;
-                g->current_room = g->current_room->connections[idx];
-                log_ghost_move(g->id, boredom, old->name, g->current_room->name);
-            } else {
-                // Ghost stays put to scare hunters
-                log_ghost_idle(g->id, boredom, g->current_room->name);
+        struct timespec deadline;
+        simclock_schedule_next(&g->schedule, &deadline); // every 300ms - slightly slower than hunters
+        if (house->reactive) {
+            // Tick again as soon as a hunter walks in. After a move the new room has not been read yet,
+            // so its generation as of now is the right starting point.
+            if (g->current_room != room) {
+                room = g->current_room;
+                seen = room_signal_seen(room, ROOM_SIGNAL_ARRIVAL);
             }
+            room_wait_signal(room, ROOM_SIGNAL_ARRIVAL, seen, &deadline, &g->running);
+        } else {
+            simclock_sleep_until(&house->waker, &deadline, &g->running);
         }
-
-        usleep(300000); // 300ms delay - slightly slower than hunters
     }
 
     return NULL;
-}
\ No newline at end of file
+}
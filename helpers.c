@@ -1,86 +1,134 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <sys/time.h>
 #include <time.h>
 #include <pthread.h>
 #include <stdint.h>
+#include <stdarg.h>
+#include <limits.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 #include "helpers.h"
+#include "logger.h"
+#include "arena.h"
 
 // ---- Room functions ----
 void room_init(struct Room* room, const char* name, bool is_exit) {
     if (!room) return;
     
-    strncpy(room->name, name, MAX_ROOM_NAME - 1);
-    room->name[MAX_ROOM_NAME - 1] = '\0';
+    room->name = name;
     room->is_exit = is_exit;
+    room->house = NULL;
+    room->conn_first = 0;
     room->conn_count = 0;
-    room->evidence_here = 0;
-    room->occupancy_count = 0;
+    atomic_init(&room->evidence_here, 0);
+    atomic_init(&room->occupancy_count, 0);
+    room->occupancy_alloc = 0;
+    room->occupancy_limit = MAX_ROOM_OCCUPANCY;
+    room->occupants = NULL;
+    for (int i = 0; i < ROOM_SIGNAL_COUNT; i++) {
+        atomic_init(&room->signal_gen[i], 0);
+    }
+    atomic_init(&room->sleepers, 0);
     pthread_mutex_init(&room->mutex, NULL);
-    
-    // Initialize all connections to NULL
-    for (int i = 0; i < MAX_CONNECTIONS; i++) {
-        room->connections[i] = NULL;
+}
+
+// ---- House layout ----
+bool house_init(struct House* house, const struct HouseMap* map) {
+    if (!map) map = map_willow();
+    if (!map) return false;
+
+    // sizeof(struct Room) is a whole number of cache lines
+    house->rooms = aligned_alloc(CACHE_LINE_SIZE, (size_t)map->room_count * sizeof(*house->rooms));
+    if (!house->rooms) return false;
+    house->room_count = (int)map->room_count;
+    house->map = map;
+    house->random_return = false;
+    house->reactive = false;
+    house->pool_workers = 0;
+    house->arena = NULL;
+    house->log_run = LOG_NO_RUN;
+
+    // Rooms carry only per-game state; names and doors stay in the shared map
+    for (uint32_t i = 0; i < map->room_count; i++) {
+        struct Room* room = house->rooms + i;
+        room_init(room, map_room_name(map, i), map->is_exit[i] != 0);
+        room->house = house;
+        room->conn_first = map->adj_offset[i];
+        room->conn_count = (int)(map->adj_offset[i + 1] - map->adj_offset[i]);
     }
-    
-    // Initialize all occupants to NULL
-    for (int i = 0; i < MAX_ROOM_OCCUPANCY; i++) {
-        room->occupants[i] = NULL;
+    house->starting_room = house->rooms + map->start_room;
+
+    // initialize casefile and house mutex
+    house->casefile.collected = 0;
+    atomic_init(&house->casefile.solved, false);
+    house->private_evidence = false;
+    if (!simclock_waker_init(&house->waker)) {
+        free(house->rooms);
+        house->rooms = NULL;
+        return false;
     }
+    sem_init(&house->casefile.mutex, 0, 1);
+    pthread_mutex_init(&house->house_mutex, NULL);
+    return true;
 }
 
-void room_connect(struct Room* a, struct Room* b) {
-    if (!a || !b) return;
-    
-    // Check if they're already connected
-    for (int i = 0; i < a->conn_count; i++) {
-        if (a->connections[i] == b) return;
+void house_cleanup(struct House* house) {
+    for (int i = 0; i < house->room_count; i++) {
+        pthread_mutex_destroy(&house->rooms[i].mutex);
+        free(house->rooms[i].occupants);
+        house->rooms[i].occupants = NULL;
+        house->rooms[i].occupancy_alloc = 0;
     }
-    
-    // Check if we have space for more connections
-    if (a->conn_count >= MAX_CONNECTIONS || b->conn_count >= MAX_CONNECTIONS) {
-        return;
+    free(house->rooms);
+    house->rooms = NULL;
+    house->room_count = 0;
+    sem_destroy(&house->casefile.mutex);
+    simclock_waker_destroy(&house->waker);
+    pthread_mutex_destroy(&house->house_mutex);
+}
+
+void house_set_room_capacity(struct House* house, int limit) {
+    for (int i = 0; i < house->room_count; i++) {
+        house->rooms[i].occupancy_limit = limit;
     }
-    
-    // Add bidirectional connection
-    a->connections[a->conn_count++] = b;
-    b->connections[b->conn_count++] = a;
 }
 
-// ---- House layout ----
-void house_populate_rooms(struct House* house) {
-    // Willow House layout from Phasmaphobia, DO NOT MODIFY HOUSE LAYOUT
-    house->room_count = 13;
-
-    room_init(house->rooms+0, "Van", true);
-    room_init(house->rooms+1, "Hallway", false);
-    room_init(house->rooms+2, "Master Bedroom", false);
-    room_init(house->rooms+3, "Boy's Bedroom", false);
-    room_init(house->rooms+4, "Bathroom", false);
-    room_init(house->rooms+5, "Basement", false);
-    room_init(house->rooms+6, "Basement Hallway", false);
-    room_init(house->rooms+7, "Right Storage Room", false);
-    room_init(house->rooms+8, "Left Storage Room", false);
-    room_init(house->rooms+9, "Kitchen", false);
-    room_init(house->rooms+10, "Living Room", false);
-    room_init(house->rooms+11, "Garage", false);
-    room_init(house->rooms+12, "Utility Room", false);
-
-    room_connect(house->rooms+0, house->rooms+1);    // Van - Hallway
-    room_connect(house->rooms+1, house->rooms+2);    // Hallway - Master Bedroom
-    room_connect(house->rooms+1, house->rooms+3);    // Hallway - Boy's Bedroom
-    room_connect(house->rooms+1, house->rooms+4);    // Hallway - Bathroom
-    room_connect(house->rooms+1, house->rooms+9);    // Hallway - Kitchen
-    room_connect(house->rooms+1, house->rooms+5);    // Hallway - Basement
-    room_connect(house->rooms+5, house->rooms+6);    // Basement - Basement Hallway
-    room_connect(house->rooms+6, house->rooms+7);    // Basement Hallway - Right Storage Room
-    room_connect(house->rooms+6, house->rooms+8);    // Basement Hallway - Left Storage Room
-    room_connect(house->rooms+9, house->rooms+10);   // Kitchen - Living Room
-    room_connect(house->rooms+9, house->rooms+11);   // Kitchen - Garage
-    room_connect(house->rooms+11, house->rooms+12);  // Garage - Utility Room
-
-    house->starting_room = house->rooms; // Van is at index 0
+void house_reset(struct House* house) {
+    for (int i = 0; i < house->room_count; i++) {
+        struct Room* room = house->rooms + i;
+        pthread_mutex_lock(&room->mutex);
+        atomic_store_explicit(&room->evidence_here, 0, memory_order_relaxed);
+        atomic_store_explicit(&room->occupancy_count, 0, memory_order_release);
+        pthread_mutex_unlock(&room->mutex);
+    }
+
+    if (house->arena) arena_reset(house->arena);
+
+    sem_wait(&house->casefile.mutex);
+    house->casefile.collected = 0;
+    atomic_store(&house->casefile.solved, false);
+    sem_post(&house->casefile.mutex);
+}
+
+// ---- Case file ----
+bool casefile_report(struct CaseFile* casefile, EvidenceByte evidence) {
+    sem_wait(&casefile->mutex);
+    casefile->collected |= evidence;
+    bool solved_now = !atomic_load_explicit(&casefile->solved, memory_order_relaxed)
+        && evidence_deduce(casefile->collected)->candidate_count == 1;
+    if (solved_now) {
+        atomic_store_explicit(&casefile->solved, true, memory_order_release);
+    }
+    sem_post(&casefile->mutex);
+    return solved_now;
+}
+
+bool casefile_is_solved(struct CaseFile* casefile) {
+    return atomic_load_explicit(&casefile->solved, memory_order_acquire);
 }
 
 // ---- to_string functions ----
@@ -192,33 +240,22 @@ int get_all_evidence_types(const enum EvidenceType** list) {
     return (int)(sizeof(evidence_types) / sizeof(evidence_types[0]));
 }
 
+// Every ghost with its index in get_all_ghost_types(). The deduction table is
+// generated from the same list, so candidate bit i always means ghost_types[i].
+#define GHOST_TYPE_LIST(X, arg) \
+    X(0, GH_POLTERGEIST, arg) X(1, GH_THE_MIMIC, arg) X(2, GH_HANTU, arg) X(3, GH_JINN, arg) \
+    X(4, GH_PHANTOM, arg) X(5, GH_BANSHEE, arg) X(6, GH_GORYO, arg) X(7, GH_BULLIES, arg) \
+    X(8, GH_MYLING, arg) X(9, GH_OBAKE, arg) X(10, GH_YUREI, arg) X(11, GH_ONI, arg) \
+    X(12, GH_MOROI, arg) X(13, GH_REVENANT, arg) X(14, GH_SHADE, arg) X(15, GH_ONRYO, arg) \
+    X(16, GH_THE_TWINS, arg) X(17, GH_DEOGEN, arg) X(18, GH_THAYE, arg) X(19, GH_YOKAI, arg) \
+    X(20, GH_WRAITH, arg) X(21, GH_RAIJU, arg) X(22, GH_MARE, arg) X(23, GH_SPIRIT, arg)
+
+#define GHOST_ENTRY(index, ghost, unused) ghost,
+
 int get_all_ghost_types(const enum GhostType** list) {
     // Stored in the data segment so that we can point to it safely
     static const enum GhostType ghost_types[] = {
-        GH_POLTERGEIST,
-        GH_THE_MIMIC,
-        GH_HANTU,
-        GH_JINN,
-        GH_PHANTOM,
-        GH_BANSHEE,
-        GH_GORYO,
-        GH_BULLIES,
-        GH_MYLING,
-        GH_OBAKE,
-        GH_YUREI,
-        GH_ONI,
-        GH_MOROI,
-        GH_REVENANT,
-        GH_SHADE,
-        GH_ONRYO,
-        GH_THE_TWINS,
-        GH_DEOGEN,
-        GH_THAYE,
-        GH_YOKAI,
-        GH_WRAITH,
-        GH_RAIJU,
-        GH_MARE,
-        GH_SPIRIT
+        GHOST_TYPE_LIST(GHOST_ENTRY, 0)
     };
 
     if (list) {
@@ -227,166 +264,241 @@ int get_all_ghost_types(const enum GhostType** list) {
     return (int)(sizeof(ghost_types) / sizeof(ghost_types[0]));
 }
 
-// ---- Thread-safe random number generation ----
-int rand_int_threadsafe(int lower_inclusive, int upper_exclusive) {
-    static _Thread_local unsigned seed = 0;
-
-    if (upper_exclusive <= lower_inclusive) {
-        return lower_inclusive;
-    }
+// ---- Evidence helpers ----
+// Deduction table, built entirely by the preprocessor: row m describes the
+// evidence mask m, so every query is one indexed load with no setup at run time
+#define EVIDENCE_FITS(mask, ghost) ((((unsigned)(mask) & ~(unsigned)(ghost)) & 0x7Fu) == 0)
+#define CANDIDATE_BIT(index, ghost, mask) | (EVIDENCE_FITS(mask, ghost) ? (1u << (index)) : 0u)
+#define CANDIDATE_ONE(index, ghost, mask) + (EVIDENCE_FITS(mask, ghost) ? 1 : 0)
+#define EXACT_GHOST(index, ghost, mask) | ((unsigned)(mask) == (unsigned)(ghost))
+#define MASK_BITS(m) (((m) & 1) + ((m) >> 1 & 1) + ((m) >> 2 & 1) + ((m) >> 3 & 1) + \
+                      ((m) >> 4 & 1) + ((m) >> 5 & 1) + ((m) >> 6 & 1))
+#define DEDUCTION_ROW(m) { \
+    0u GHOST_TYPE_LIST(CANDIDATE_BIT, m), \
+    MASK_BITS(m), \
+    0 GHOST_TYPE_LIST(CANDIDATE_ONE, m), \
+    0 GHOST_TYPE_LIST(EXACT_GHOST, m) }
+#define DEDUCTION_ROWS8(b) DEDUCTION_ROW((b) + 0), DEDUCTION_ROW((b) + 1), DEDUCTION_ROW((b) + 2), \
+    DEDUCTION_ROW((b) + 3), DEDUCTION_ROW((b) + 4), DEDUCTION_ROW((b) + 5), DEDUCTION_ROW((b) + 6), \
+    DEDUCTION_ROW((b) + 7)
+
+static const struct EvidenceDeduction deduction_table[EVIDENCE_MASK_COUNT] = {
+    DEDUCTION_ROWS8(0),   DEDUCTION_ROWS8(8),   DEDUCTION_ROWS8(16),  DEDUCTION_ROWS8(24),
+    DEDUCTION_ROWS8(32),  DEDUCTION_ROWS8(40),  DEDUCTION_ROWS8(48),  DEDUCTION_ROWS8(56),
+    DEDUCTION_ROWS8(64),  DEDUCTION_ROWS8(72),  DEDUCTION_ROWS8(80),  DEDUCTION_ROWS8(88),
+    DEDUCTION_ROWS8(96),  DEDUCTION_ROWS8(104), DEDUCTION_ROWS8(112), DEDUCTION_ROWS8(120)
+};
 
-    if (seed == 0) {
-        seed = (unsigned)time(NULL) ^ (unsigned)(uintptr_t)pthread_self();
-        if (seed == 0) {
-            seed = 0xA5A5A5A5u;
-        }
-    }
+const struct EvidenceDeduction* evidence_deduce(EvidenceByte mask) {
+    return &deduction_table[mask & (EVIDENCE_MASK_COUNT - 1)];
+}
 
-    unsigned span = (unsigned)(upper_exclusive - lower_inclusive);
-    unsigned value = (unsigned)rand_r(&seed) % span;
-    return lower_inclusive + (int)value;
+int ghost_type_index(enum GhostType ghost) {
+    // A ghost's own evidence fits only that ghost
+    const struct EvidenceDeduction* deduction = evidence_deduce((EvidenceByte)ghost);
+    return deduction->identifies ? __builtin_ctz(deduction->candidates) : -1;
 }
 
-// ---- Evidence helpers ----
 bool evidence_is_valid_ghost(EvidenceByte mask) {
-    const enum GhostType* ghost_types = NULL;
-    int ghost_count = get_all_ghost_types(&ghost_types);
-
-    for (int index = 0; index < ghost_count; index++) {
-        if (mask == (EvidenceByte)ghost_types[index]) {
-            return true;
-        }
-    }
-
-    return false;
+    return (mask & ~(EVIDENCE_MASK_COUNT - 1)) == 0 && evidence_deduce(mask)->identifies;
 }
 
 bool evidence_has_three_unique(EvidenceByte mask) {
-    int count = 0;
-    
-    // Count the number of bits set in the mask
-    for (int i = 0; i < 7; i++) {
-        if (mask & (1 << i)) {
-            count++;
-        }
-    }
-    
-    return count >= 3;
+    return evidence_deduce(mask)->evidence_count >= 3;
 }
 
-// ---- Room occupancy helpers ----
 bool room_add_hunter(struct Room* room, struct Hunter* hunter) {
-    if (!room || !hunter || room->occupancy_count >= MAX_ROOM_OCCUPANCY) {
+    if (!room || !hunter) {
         return false;
     }
-    
+
+    // The caller holds room->mutex, so only this thread changes the count
+    int count = atomic_load_explicit(&room->occupancy_count, memory_order_relaxed);
+
     // Check if hunter already in room
-    for (int i = 0; i < room->occupancy_count; i++) {
-        if (room->occupants[i] == hunter) {
-            return true; // Already in room
-        }
+    int slot = hunter->room_slot;
+    if (slot >= 0 && slot < count && room->occupants[slot] == hunter) {
+        return true; // Already in room
     }
-    
-    room->occupants[room->occupancy_count++] = hunter;
+
+    if (room->occupancy_limit > 0 && count >= room->occupancy_limit) {
+        return false;
+    }
+
+    if (count == room->occupancy_alloc) {
+        // Whole cache lines, so neighbouring rooms' lists never share one
+        int grown = room->occupancy_alloc ? room->occupancy_alloc * 2 : MAX_ROOM_OCCUPANCY;
+        size_t bytes = ((size_t)grown * sizeof(struct Hunter*) + CACHE_LINE_SIZE - 1) & ~(size_t)(CACHE_LINE_SIZE - 1);
+        struct Hunter** occupants = aligned_alloc(CACHE_LINE_SIZE, bytes);
+        if (!occupants) return false;
+        if (count > 0) memcpy(occupants, room->occupants, (size_t)count * sizeof(*occupants));
+        free(room->occupants);
+        room->occupants = occupants;
+        room->occupancy_alloc = grown;
+    }
+
+    hunter->room_slot = count;
+    room->occupants[count] = hunter;
+    atomic_store_explicit(&room->occupancy_count, count + 1, memory_order_release);
+    room_signal(room, ROOM_SIGNAL_ARRIVAL);
     return true;
 }
 
 void room_remove_hunter(struct Room* room, struct Hunter* hunter) {
     if (!room || !hunter) return;
-    
-    // Find and remove hunter
-    for (int i = 0; i < room->occupancy_count; i++) {
-        if (room->occupants[i] == hunter) {
-            // Shift remaining hunters
-            for (int j = i; j < room->occupancy_count - 1; j++) {
-                room->occupants[j] = room->occupants[j + 1];
-            }
-            room->occupancy_count--;
-            room->occupants[room->occupancy_count] = NULL;
-            break;
-        }
+
+    int count = atomic_load_explicit(&room->occupancy_count, memory_order_relaxed);
+    int slot = hunter->room_slot;
+    if (slot < 0 || slot >= count || room->occupants[slot] != hunter) {
+        return; // Not in this room
+    }
+
+    // Move the last hunter into the freed slot
+    struct Hunter* last = room->occupants[count - 1];
+    room->occupants[slot] = last;
+    last->room_slot = slot;
+    hunter->room_slot = -1;
+    atomic_store_explicit(&room->occupancy_count, count - 1, memory_order_release);
+}
+
+bool room_transfer_hunter(struct Room* from, struct Room* to, struct Hunter* hunter) {
+    if (from == to) return true;
+
+    // Rooms of a house live in one array, so address order is a global lock order
+    struct Room* first = from < to ? from : to;
+    struct Room* second = from < to ? to : from;
+    pthread_mutex_lock(&first->mutex);
+    pthread_mutex_lock(&second->mutex);
+
+    // Join the new room before leaving the old one so presence checks never see
+    // the hunter in neither room
+    int from_slot = hunter->room_slot;
+    bool moved = room_add_hunter(to, hunter);
+    if (moved) {
+        int to_slot = hunter->room_slot;
+        hunter->room_slot = from_slot;
+        room_remove_hunter(from, hunter);
+        hunter->room_slot = to_slot;
     }
+
+    pthread_mutex_unlock(&second->mutex);
+    pthread_mutex_unlock(&first->mutex);
+    return moved;
+}
+
+int room_occupancy(struct Room* room) {
+    return atomic_load_explicit(&room->occupancy_count, memory_order_acquire);
 }
 
 bool room_has_hunters(struct Room* room) {
-    return room ? room->occupancy_count > 0 : false;
+    return room ? room_occupancy(room) > 0 : false;
 }
 
-// ---- Logging (Writes CSV logs, DO NOT MODIFY the file outputs: timestamp,type,id,room,device,boredom,fear,action,extra) ----
+// Evidence is a single byte with no other data published alongside it, so
+// relaxed atomics are enough: each read-modify-write still sees every earlier one
+EvidenceByte room_evidence(struct Room* room) {
+    return atomic_load_explicit(&room->evidence_here, memory_order_relaxed);
+}
 
-// These enums are just for logging purposes, not needed elsewhere
-enum LogEntityType {
-    LOG_ENTITY_HUNTER = 0,
-    LOG_ENTITY_GHOST = 1
-};
+EvidenceByte room_place_evidence(struct Room* room, EvidenceByte evidence) {
+    EvidenceByte before = atomic_fetch_or_explicit(&room->evidence_here, evidence, memory_order_relaxed);
+    EvidenceByte added = evidence & (EvidenceByte)~before;
+    if (added) room_signal(room, ROOM_SIGNAL_EVIDENCE);
+    return added;
+}
 
-struct LogRecord {
-    enum LogEntityType entity_type;
-    int                entity_id;
-    const char*        room;
-    const char*        device;
-    int                boredom;
-    int                fear;
-    const char*        action;
-    const char*        extra;
-};
+EvidenceByte room_claim_evidence(struct Room* room, EvidenceByte device) {
+    // Skip the write (and the cache-line transfer) when there is nothing to take
+    if ((room_evidence(room) & device) == 0) return 0;
+    EvidenceByte before = atomic_fetch_and_explicit(&room->evidence_here, (EvidenceByte)~device, memory_order_relaxed);
+    return before & device;
+}
 
-static const char* log_entity_type_to_string(enum LogEntityType type) {
-    switch (type) {
-        case LOG_ENTITY_HUNTER:
-            return "hunter";
-        case LOG_ENTITY_GHOST:
-            return "ghost";
-        default:
-            return "unknown";
-    }
+// ---- Room signals ----
+// Each signal is a generation word that waiters block on with a futex, so a
+// change reaches a sleeping entity in microseconds. Writers pay one atomic add
+// and only make the wake syscall when somebody is asleep on the room.
+#ifdef __linux__
+// FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC deadline
+static void futex_wait_word(atomic_uint* word, unsigned seen, const struct timespec* deadline) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAIT_BITSET_PRIVATE, seen, deadline, NULL, FUTEX_BITSET_MATCH_ANY);
 }
 
-static void write_log_record(const struct LogRecord* record) {
-    static _Thread_local unsigned line_count = 0;
+static void futex_wake_word(atomic_uint* word) {
+    syscall(SYS_futex, (uint32_t*)word, FUTEX_WAKE_PRIVATE, INT_MAX, NULL, NULL, 0);
+}
+#else
+// Without futexes waiting degrades to sleeping until the deadline (plain pacing)
+static void futex_wait_word(atomic_uint* word, unsigned seen, const struct timespec* deadline) {
+    (void)word;
+    (void)seen;
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, deadline, NULL);
+}
 
-    if (line_count >= 100000) {
-        fprintf(stderr, "Log capped for entity %d; stopping to prevent infinite growth.\n", record->entity_id);
-        exit(1);
-    }
+static void futex_wake_word(atomic_uint* word) {
+    (void)word;
+}
+#endif
 
-    char filename[64];
-    snprintf(filename, sizeof(filename), "log_%d.csv", record->entity_id);
+unsigned room_signal_seen(struct Room* room, enum RoomSignal signal) {
+    return atomic_load(&room->signal_gen[signal]);
+}
 
-    FILE* log_file = fopen(filename, "a");
+void room_signal(struct Room* room, enum RoomSignal signal) {
+    // Both sides are seq_cst: either this load sees the sleeper, or the
+    // sleeper's futex compare sees the new generation and does not block
+    atomic_fetch_add(&room->signal_gen[signal], 1);
+    if (atomic_load(&room->sleepers) > 0) {
+        futex_wake_word(&room->signal_gen[signal]);
+    }
+}
 
-    if (!log_file) {
-        return;
+bool room_wait_signal(struct Room* room, enum RoomSignal signal, unsigned seen, const struct timespec* deadline,
+                      const atomic_bool* running) {
+    struct timespec now;
+    atomic_fetch_add(&room->sleepers, 1);
+    bool signalled = false;
+    while (atomic_load(running)) {
+        if (atomic_load(&room->signal_gen[signal]) != seen) {
+            signalled = true;
+            break;
+        }
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (now.tv_sec > deadline->tv_sec || (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec)) break;
+        futex_wait_word(&room->signal_gen[signal], seen, deadline); // also returns on EINTR/EAGAIN
     }
+    atomic_fetch_sub(&room->sleepers, 1);
+    return signalled;
+}
 
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    long long timestamp = (long long)tv.tv_sec * 1000LL + (long long)tv.tv_usec / 1000LL;
+void house_wake_all(struct House* house) {
+    simclock_wake_all(&house->waker);
+    if (!house->reactive) return;
+    for (int i = 0; i < house->room_count; i++) {
+        struct Room* room = house->rooms + i;
+        if (atomic_load(&room->sleepers) == 0) continue;
+        for (int s = 0; s < ROOM_SIGNAL_COUNT; s++) {
+            room_signal(room, (enum RoomSignal)s);
+        }
+    }
+}
 
-    const char* entity = log_entity_type_to_string(record->entity_type);
-    const char* room = record->room ? record->room : "";
-    const char* device = record->device ? record->device : "";
-    const char* action = record->action ? record->action : "";
-    const char* extra = record->extra ? record->extra : "";
+// ---- Logging (Writes CSV logs, DO NOT MODIFY the file outputs: timestamp,type,id,room,device,boredom,fear,action,extra) ----
+// Records are buffered per entity by logger.c and written on size/time thresholds or at shutdown.
 
-    fprintf(log_file,
-            "%lld,%s,%d,%s,%s,%d,%d,%s,%s\n",
-            timestamp,
-            entity,
-            record->entity_id,
-            room,
-            device,
-            record->boredom,
-            record->fear,
-            action,
-            extra);
+static bool log_console = true;
 
-    fclose(log_file);
-    line_count++;
+void log_set_console(bool enabled) {
+    log_console = enabled;
+}
 
-    // Short pause helps ensure successive logs receive distinct timestamps.
-    struct timespec pause = {0, 2 * 1000 * 1000}; // 2 ms
-    nanosleep(&pause, NULL);
+// Console echo of each log line; silenced in batch mode
+static void log_print(const char* format, ...) {
+    if (!log_console) return;
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
 }
 
 void log_move(int hunter_id, int boredom, int fear, const char* from_room, const char* to_room, enum EvidenceType device) {
@@ -401,9 +513,9 @@ void log_move(int hunter_id, int boredom, int fear, const char* from_room, const
         .extra = to_room
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Hunter %d using %s moved from %s to %s (bored=%d fear=%d)\n",
+    log_print("Hunter %d using %s moved from %s to %s (bored=%d fear=%d)\n",
            hunter_id,
            evidence_to_string(device),
            from_room ? from_room : "",
@@ -425,9 +537,9 @@ void log_evidence(int hunter_id, int boredom, int fear, const char* room_name, e
         .extra = evidence
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Hunter %d using %s gathered evidence in %s (bored=%d fear=%d)\n",
+    log_print("Hunter %d using %s gathered evidence in %s (bored=%d fear=%d)\n",
            hunter_id,
            evidence,
            room_name ? room_name : "",
@@ -452,9 +564,9 @@ void log_swap(int hunter_id, int boredom, int fear, enum EvidenceType from_devic
         .extra = extra
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Hunter %d swapped devices: %s -> %s (bored=%d fear=%d)\n",
+    log_print("Hunter %d swapped devices: %s -> %s (bored=%d fear=%d)\n",
            hunter_id,
            from_text,
            to_text,
@@ -477,9 +589,9 @@ void log_exit(int hunter_id, int boredom, int fear, const char* room_name, enum
         .extra = reason_text
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Hunter %d using %s exited at %s (reason=%s, bored=%d fear=%d)\n",
+    log_print("Hunter %d using %s exited at %s (reason=%s, bored=%d fear=%d)\n",
            hunter_id,
            device_text,
            room_name ? room_name : "",
@@ -504,17 +616,17 @@ void log_return_to_van(int hunter_id, int boredom, int fear, const char* room_na
         .extra = extra
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
     if (heading_home) {
-        printf("Hunter %d using %s heading to van from %s (bored=%d fear=%d)\n",
+        log_print("Hunter %d using %s heading to van from %s (bored=%d fear=%d)\n",
                hunter_id,
                device_text,
                room_name ? room_name : "",
                boredom,
                fear);
     } else {
-        printf("Hunter %d using %s finished return at %s (bored=%d fear=%d)\n",
+        log_print("Hunter %d using %s finished return at %s (bored=%d fear=%d)\n",
                hunter_id,
                device_text,
                room_name ? room_name : "",
@@ -536,8 +648,8 @@ void log_hunter_init(int hunter_id, const char* room_name, const char* hunter_na
         .extra = hunter_name ? hunter_name : ""
     };
 
-    write_log_record(&record);
-    printf("Hunter %d (%s) initialized in %s with %s\n",
+    logger_write(&record);
+    log_print("Hunter %d (%s) initialized in %s with %s\n",
            hunter_id,
            hunter_name ? hunter_name : "unknown",
            room_name ? room_name : "",
@@ -557,8 +669,8 @@ void log_ghost_init(int ghost_id, const char* room_name, enum GhostType type) {
         .extra = type_text
     };
 
-    write_log_record(&record);
-    printf("Ghost %d (%s) initialized in %s\n",
+    logger_write(&record);
+    log_print("Ghost %d (%s) initialized in %s\n",
            ghost_id,
            type_text,
            room_name ? room_name : "");
@@ -576,9 +688,9 @@ void log_ghost_move(int ghost_id, int boredom, const char* from_room, const char
         .extra = to_room
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Ghost %d [bored=%d] MOVE %s -> %s\n",
+    log_print("Ghost %d [bored=%d] MOVE %s -> %s\n",
            ghost_id,
            boredom,
            from_room ? from_room : "",
@@ -599,9 +711,9 @@ void log_ghost_evidence(int ghost_id, int boredom, const char* room_name, enum E
         .extra = evidence_text
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Ghost %d [bored=%d] EVIDENCE %s in %s\n",
+    log_print("Ghost %d [bored=%d] EVIDENCE %s in %s\n",
            ghost_id,
            boredom,
            evidence_text,
@@ -620,9 +732,9 @@ void log_ghost_exit(int ghost_id, int boredom, const char* room_name) {
         .extra = ""
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Ghost %d [bored=%d] EXIT %s\n",
+    log_print("Ghost %d [bored=%d] EXIT %s\n",
            ghost_id,
            boredom,
            room_name ? room_name : "");
@@ -640,9 +752,9 @@ void log_ghost_idle(int ghost_id, int boredom, const char* room_name) {
         .extra = ""
     };
 
-    write_log_record(&record);
+    logger_write(&record);
 
-    printf("Ghost %d [bored=%d] IDLE in %s\n",
+    log_print("Ghost %d [bored=%d] IDLE in %s\n",
            ghost_id,
            boredom,
            room_name ? room_name : "");
@@ -38,13 +38,29 @@ int get_all_evidence_types(const enum EvidenceType** list);
  */
 int get_all_ghost_types(const enum GhostType** list);
 
+#define EVIDENCE_MASK_COUNT 128   // every combination of the seven evidence bits
+
+// What a set of collected evidence says about the ghost
+struct EvidenceDeduction {
+    uint32_t candidates;      // bit i set when ghost i of get_all_ghost_types() fits the evidence
+    uint8_t evidence_count;   // distinct evidence types in the mask
+    uint8_t candidate_count;  // ghosts that still fit
+    bool identifies;          // the mask is exactly one ghost's evidence set
+};
+
 /**
- * @brief Thread-safe random integer helper.
- * @param[in] lower_inclusive Minimum value (inclusive).
- * @param[in] upper_exclusive Maximum value (exclusive).
- * @return Random number in [lower_inclusive, upper_exclusive).
+ * @brief Look up an evidence mask in the precomputed 128-entry deduction table.
+ * @param[in] mask Collected evidence; bits above the seven evidence types are ignored.
+ * @return Table row for the mask, valid for the life of the program.
  */
-int rand_int_threadsafe(int lower_inclusive, int upper_exclusive);
+const struct EvidenceDeduction* evidence_deduce(EvidenceByte mask);
+
+/**
+ * @brief Position of a ghost type in get_all_ghost_types().
+ * @param[in] ghost Ghost type value.
+ * @return Index in [0, 24), or -1 for a value that is not a ghost type.
+ */
+int ghost_type_index(enum GhostType ghost);
 
 /**
  * @brief Verify whether an evidence mask matches a supported ghost type.
@@ -61,32 +77,160 @@ bool evidence_is_valid_ghost(EvidenceByte mask);
 bool evidence_has_three_unique(EvidenceByte mask);
 
 /**
- * @brief Add a hunter to a room's occupancy list.
+ * @brief Add a hunter to a room's occupancy list in O(1). The caller holds
+ *        room->mutex; the count is published atomically for lock-free readers.
  * @param[in,out] room Room to add hunter to.
- * @param[in] hunter Hunter to add.
- * @return true when hunter was added successfully.
+ * @param[in,out] hunter Hunter to add; its room_slot is updated.
+ * @return true when hunter was added (or already present); false when the
+ *         room is at its occupancy limit.
  */
 bool room_add_hunter(struct Room* room, struct Hunter* hunter);
 
 /**
- * @brief Remove a hunter from a room's occupancy list.
+ * @brief Remove a hunter from a room's occupancy list in O(1). The caller
+ *        holds room->mutex.
  * @param[in,out] room Room to remove hunter from.
- * @param[in] hunter Hunter to remove.
+ * @param[in,out] hunter Hunter to remove; ignored when not in this room.
  */
 void room_remove_hunter(struct Room* room, struct Hunter* hunter);
 
 /**
- * @brief Check if a room has any hunters in it.
+ * @brief Move a hunter between two rooms in one step. Both room locks are taken
+ *        in address order, the hunter joins the new room and then leaves the
+ *        old one, so it is always visible in at least one of them.
+ * @param[in,out] from Room the hunter is listed in.
+ * @param[in,out] to Destination room.
+ * @param[in,out] hunter Hunter to move; its room_slot is updated.
+ * @return false when the destination is full; the hunter stays in from.
+ */
+bool room_transfer_hunter(struct Room* from, struct Room* to, struct Hunter* hunter);
+
+/**
+ * @brief Number of hunters in a room, read with one atomic load (no lock).
+ * @param[in] room Room to check.
+ * @return Current occupancy; may be stale by the time the caller acts on it.
+ */
+int room_occupancy(struct Room* room);
+
+/**
+ * @brief Check if a room has any hunters in it (one atomic load, no lock).
  * @param[in] room Room to check.
  * @return true when room has at least one hunter.
  */
 bool room_has_hunters(struct Room* room);
 
 /**
- * @brief Populate the house structure with the Willow layout.
- * @param[in,out] house House to populate; starting_room is set to the van.
+ * @brief Read the evidence currently left in a room (lock-free).
+ * @param[in] room Room to inspect.
+ * @return Evidence bitmask.
+ */
+EvidenceByte room_evidence(struct Room* room);
+
+/**
+ * @brief Leave evidence in a room with an atomic fetch-or.
+ * @param[in,out] room Room to haunt.
+ * @param[in] evidence Bits to add.
+ * @return Bits that were not already present.
+ */
+EvidenceByte room_place_evidence(struct Room* room, EvidenceByte evidence);
+
+/**
+ * @brief Take the evidence a device can detect with an atomic fetch-and.
+ *        When several hunters claim the same bit at once exactly one of
+ *        them gets it.
+ * @param[in,out] room Room to search.
+ * @param[in] device Evidence bits the hunter's device detects.
+ * @return Bits this caller removed from the room.
+ */
+EvidenceByte room_claim_evidence(struct Room* room, EvidenceByte device);
+
+/**
+ * @brief Current generation of one room signal. Read it before deciding to
+ *        sleep and pass it to room_wait_signal.
+ * @param[in] room Room to watch.
+ * @param[in] signal Which change to watch for.
+ * @return Generation counter.
+ */
+unsigned room_signal_seen(struct Room* room, enum RoomSignal signal);
+
+/**
+ * @brief Announce a change and wake every thread waiting on it. Called by
+ *        room_place_evidence (new bits only) and room_add_hunter.
+ * @param[in,out] room Room that changed.
+ * @param[in] signal Kind of change.
+ */
+void room_signal(struct Room* room, enum RoomSignal signal);
+
+/**
+ * @brief Block until the signal moves past seen, *running is cleared, or
+ *        the deadline passes.
+ * @param[in,out] room Room to wait on.
+ * @param[in] signal Change to wait for.
+ * @param[in] seen Generation from room_signal_seen.
+ * @param[in] deadline Absolute CLOCK_MONOTONIC time of the entity's next tick.
+ * @param[in] running The caller's stop flag.
+ * @return true when woken by the signal.
+ */
+bool room_wait_signal(struct Room* room, enum RoomSignal signal, unsigned seen, const struct timespec* deadline,
+                      const atomic_bool* running);
+
+/**
+ * @brief Wake every sleeping entity in a house: the tick waker and, in
+ *        reactive mode, all room signals. Clear running flags first.
+ * @param[in,out] house House whose entities should re-check their state.
+ */
+void house_wake_all(struct House* house);
+
+/**
+ * @brief Create the rooms of a house from a map and initialise its case file
+ *        and locks.
+ * @param[out] house House to set up.
+ * @param[in] map Layout to use, NULL for Willow; must outlive the house.
+ * @return false when out of memory.
+ */
+bool house_init(struct House* house, const struct HouseMap* map);
+
+/**
+ * @brief Destroy the locks and rooms created by house_init.
+ * @param[in,out] house House to tear down.
+ */
+void house_cleanup(struct House* house);
+
+/**
+ * @brief Set how many hunters each room may hold at once.
+ * @param[in,out] house House whose rooms are updated.
+ * @param[in] limit Hunters per room; 0 removes the limit.
+ */
+void house_set_room_capacity(struct House* house, int limit);
+
+/**
+ * @brief Clear per-game room state (evidence, occupants) and the case file so
+ *        the same house can host another simulation.
+ * @param[in,out] house House built by house_init.
+ */
+void house_reset(struct House* house);
+
+/**
+ * @brief Add evidence a hunter found to the shared case file and mark the case
+ *        solved once the combined evidence leaves exactly one candidate ghost.
+ * @param[in,out] casefile The house's case file.
+ * @param[in] evidence Evidence bits to report.
+ * @return true when this report solved the case.
+ */
+bool casefile_report(struct CaseFile* casefile, EvidenceByte evidence);
+
+/**
+ * @brief Check whether the case is solved (one atomic load, no lock).
+ * @param[in] casefile The house's case file.
+ * @return true once casefile_report has solved the case.
+ */
+bool casefile_is_solved(struct CaseFile* casefile);
+
+/**
+ * @brief Enable or disable echoing log entries to stdout (enabled by default).
+ * @param[in] enabled false keeps the CSV logs but prints nothing.
  */
-void house_populate_rooms(struct House* house);
+void log_set_console(bool enabled);
 
 /**
  * @brief Append a MOVE entry for a hunter.
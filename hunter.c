@@ -1,26 +1,43 @@
 #include "defs.h"
 #include "helpers.h"
+#include "logger.h"
 #include "roomstack.h"
+#include "hunterrules.h"
 #include <stdlib.h>
 #include <unistd.h>
 #include <time.h>
 #include <pthread.h>
 
-void* hunter_thread_fn(void* arg) {
-    struct Hunter* h = (struct Hunter*)arg;
-    if (!h || !h->current_room) return NULL;
+// Take the hunter off its room's occupancy list
+static void hunter_leave_room(struct Hunter* h) {
+    pthread_mutex_lock(&h->current_room->mutex);
+    room_remove_hunter(h->current_room, h);
+    pthread_mutex_unlock(&h->current_room->mutex);
+}
 
-    // Initialize breadcrumb stack
-    stack_init(&h->breadcrumb);
+// Log the exit and release the breadcrumb trail once the hunter leaves
+static void hunter_finish(struct Hunter* h) {
+    if (h->returning_to_van && !h->current_room->is_exit) {
+        h->van_trips_abandoned++;
+        h->van_trip_ticks += h->trip_ticks;
+    }
+    log_exit(h->id, h->boredom, h->fear, h->current_room->name, h->current_device, h->exit_reason);
+    stack_clear(&h->breadcrumb);
+}
+
+void hunter_start(struct Hunter* h) {
+    // Initialize breadcrumb stack (reuses the buffer of a previous game)
+    stack_set_limit(&h->breadcrumb, HUNTER_BREADCRUMB_DEPTH);
 
     // R-16.3: Hunter starts with random device
     const enum EvidenceType* evidence_types;
     int evidence_count = get_all_evidence_types(&evidence_types);
-    h->current_device = evidence_types[rand_int_threadsafe(0, evidence_count)];
+    h->current_device = evidence_types[rng_range(&h->rng, 0, evidence_count)];
 
     // R-16.4: Add hunter to van room (with special case for first room)
     pthread_mutex_lock(&h->current_room->mutex);
-    if (!h->current_room->is_exit || h->current_room->occupancy_count < MAX_ROOM_OCCUPANCY) {
+    if (!h->current_room->is_exit || h->current_room->occupancy_limit == 0 ||
+        room_occupancy(h->current_room) < h->current_room->occupancy_limit) {
         room_add_hunter(h->current_room, h);
     }
     pthread_mutex_unlock(&h->current_room->mutex);
@@ -29,165 +46,187 @@ void* hunter_thread_fn(void* arg) {
     h->boredom = 0;
     h->fear = 0;
     h->collected = 0;
+    h->returning_to_van = false;
+    h->trip_ticks = 0;
+    h->van_trips = 0;
+    h->van_trip_ticks = 0;
+    h->van_trips_abandoned = 0;
 
     // Log hunter starting
     log_hunter_init(h->id, h->current_room->name, h->name, h->current_device);
+}
+
+bool hunter_tick(struct Hunter* h) {
+    if (h->boredom >= ENTITY_BOREDOM_MAX || h->fear >= HUNTER_FEAR_MAX) {
+        hunter_finish(h);
+        return false;
+    }
 
-    bool returning_to_van = false;
+    // Stopped from outside: leave with whatever reason was last recorded
+    if (!atomic_load(&h->running)) {
+        hunter_leave_room(h);
+        hunter_finish(h);
+        return false;
+    }
 
-    while (h->boredom < ENTITY_BOREDOM_MAX && h->fear < HUNTER_FEAR_MAX) {
-        // R-17: Update Stats (Ghost Check)
-        pthread_mutex_lock(&h->current_room->mutex);
+    // Case closed: the team's combined evidence already names the ghost
+    struct House* house = h->current_room->house;
+    if (!house->private_evidence && casefile_is_solved(&house->casefile)) {
+        hunter_leave_room(h);
+        h->returning_to_van = false; // the trip is moot, not abandoned
+        h->exit_reason = LR_EVIDENCE;
+        hunter_finish(h);
+        return false;
+    }
+
+    const enum EvidenceType* evidence_types;
+    int evidence_count = get_all_evidence_types(&evidence_types);
+
+    // R-17: Update Stats (Ghost Check)
+    EvidenceByte evidence_here = room_evidence(h->current_room);
+
+    // Evidence presence indicates the ghost was recently here; EMF, the most
+    // direct indicator, adds extra fear (same rule as the hunter store)
+    hunter_rule_stats(evidence_here, &h->boredom, &h->fear);
+
+    // R-18: Van / Exit Room Check
+    if (h->current_room->is_exit) {
+        // R-18.1: Clear breadcrumb stack
+        stack_clear(&h->breadcrumb);
         
-        // Check if ghost is in room (evidence presence indicates ghost was recently here)
-        bool ghost_present = (h->current_room->evidence_here != 0);
-        if (ghost_present) {
-            h->boredom = 0;
-            h->fear++;
-            
-            // Also check for EMF specifically as it's the most direct ghost indicator
-            if (h->current_room->evidence_here & EV_EMF) {
-                h->fear++; // Extra fear for EMF readings
-            }
-        } else {
-            h->boredom++;
+        // R-18.2: Check for Victory
+        // Check if evidence collection is complete
+        if (evidence_has_three_unique(h->collected)) {
+            hunter_leave_room(h);
+            h->exit_reason = LR_EVIDENCE;
+            hunter_finish(h);
+            return false;
         }
         
-        pthread_mutex_unlock(&h->current_room->mutex);
-
-        // R-18: Van / Exit Room Check
-        if (h->current_room->is_exit) {
-            // R-18.1: Clear breadcrumb stack
-            stack_clear(&h->breadcrumb);
-            
-            // R-18.2: Check for Victory
-            // Check if evidence collection is complete
-            if (evidence_has_three_unique(h->collected)) {
-                room_remove_hunter(h->current_room, h);
-                h->exit_reason = LR_EVIDENCE;
-                break;
-            }
-            
-            // R-18.3: Swap to new device
-            h->current_device = evidence_types[rand_int_threadsafe(0, evidence_count)];
-        }
+        // R-18.3: Swap to new device
+        h->current_device = evidence_types[rng_range(&h->rng, 0, evidence_count)];
+    }
+
+    // R-19: Condition Check (Boredom / Fear)
+    int verdict = hunter_rule_verdict(h->boredom, h->fear);
+    if (verdict != HUNTER_STAYS) {
+        hunter_leave_room(h);
+        h->exit_reason = (enum LogReason)verdict;
+        hunter_finish(h);
+        return false;
+    }
 
-        // R-19: Condition Check (Boredom / Fear)
-        if (h->boredom >= ENTITY_BOREDOM_MAX) {
-            room_remove_hunter(h->current_room, h);
-            h->exit_reason = LR_BORED;
-            break;
+    // R-20: Attempt to Gather Evidence
+    // R-20.1.1: Clear evidence bit from room (only one hunter can claim each bit)
+    EvidenceByte matching_evidence = room_claim_evidence(h->current_room, h->current_device);
+    
+    if (matching_evidence) {
+        // R-20.1.2: Add to hunter's collected evidence and share it on the case file
+        h->collected |= matching_evidence;
+        if (!house->private_evidence && casefile_report(&house->casefile, matching_evidence)) {
+            house_wake_all(house); // everyone else can leave now, not next tick
         }
-        if (h->fear >= HUNTER_FEAR_MAX) {
-            room_remove_hunter(h->current_room, h);
-            h->exit_reason = LR_AFRAID;
-            break;
+        
+        // R-20.1 Set return flag unless already in exit room
+        if (!h->current_room->is_exit) {
+            h->returning_to_van = true;
         }
-
-        // R-20: Attempt to Gather Evidence
-        pthread_mutex_lock(&h->current_room->mutex);
         
-        EvidenceByte matching_evidence = h->current_room->evidence_here & h->current_device;
+        log_evidence(h->id, h->boredom, h->fear, h->current_room->name, h->current_device);
+    } else {
+        // R-20.2: Small random chance to return to van for equipment change
+        if (rng_range(&h->rng, 0, 100) < 20) { // 20% chance (increased for better gameplay)
+            h->returning_to_van = true;
+        }
         
-        if (matching_evidence) {
-            // R-20.1.1: Clear evidence bit from room
-            h->current_room->evidence_here &= ~matching_evidence;
-            
-            // R-20.1.2: Add to hunter's collected evidence
-            h->collected |= matching_evidence;
-            
-            // R-20.1 Set return flag unless already in exit room
-            if (!h->current_room->is_exit) {
-                returning_to_van = true;
-            }
-            
-            log_evidence(h->id, h->boredom, h->fear, h->current_room->name, h->current_device);
-        } else {
-            // R-20.2: Small random chance to return to van for equipment change
-            if (rand_int_threadsafe(0, 100) < 20) { // 20% chance (increased for better gameplay)
-                returning_to_van = true;
-            }
-            
-            // Smart strategy: If room has evidence that hunter's device can't detect,
-            // hunter should consider coming back with different equipment
-            if (h->current_room->evidence_here != 0) {
-                // Try a different device next time at van
-                if (rand_int_threadsafe(0, 100) < 30) { // 30% chance to swap devices
-                    returning_to_van = true;
-                }
+        // Smart strategy: If room has evidence that hunter's device can't detect,
+        // hunter should consider coming back with different equipment
+        if (room_evidence(h->current_room) != 0) {
+            // Try a different device next time at van
+            if (rng_range(&h->rng, 0, 100) < 30) { // 30% chance to swap devices
+                h->returning_to_van = true;
             }
         }
-        
-        pthread_mutex_unlock(&h->current_room->mutex);
+    }
 
-        
+    
 
-        // Movement logic
-        if (h->current_room->conn_count > 0) {
-            struct Room* old = h->current_room;
-            
-            // Remove from current room
-            pthread_mutex_lock(&old->mutex);
-            room_remove_hunter(old, h);
-            pthread_mutex_unlock(&old->mutex);
-            
-            // Choose next room (prioritize van if returning)
-            int next;
-            if (returning_to_van) {
-                // Try to find path to van (simple implementation)
-                next = 0; // default to first connection
-                bool found_exit = false;
-                for (int i = 0; i < old->conn_count; i++) {
-                    if (old->connections[i] && old->connections[i]->is_exit) {
-                        next = i;
-                        found_exit = true;
-                        break;
-                    }
-                }
-                if (!found_exit) {
-                    next = rand_int_threadsafe(0, old->conn_count);
+    // Movement logic
+    if (h->current_room->conn_count > 0) {
+        struct Room* old = h->current_room;
+        
+        // Choose next room (prioritize van if returning)
+        struct Room* next = NULL;
+        if (h->returning_to_van && !old->house->random_return) {
+            // Follow the house's precomputed route: one step closer to the nearest exit
+            next = room_exit_hop(old);
+        }
+        if (!next && h->returning_to_van) {
+            // Already at an exit (or cut off): take an adjacent exit if there is one
+            for (int i = 0; i < old->conn_count; i++) {
+                if (room_neighbor(old, i)->is_exit) {
+                    next = room_neighbor(old, i);
+                    break;
                 }
-            } else {
-                next = rand_int_threadsafe(0, old->conn_count);
-            }
-            
-            // Validate next connection exists
-            if (next >= 0 && next < old->conn_count && old->connections[next]) {
-                h->current_room = old->connections[next];
-            } else {
-                // Invalid connection, skip movement
-                pthread_mutex_lock(&old->mutex);
-                room_add_hunter(old, h);
-                pthread_mutex_unlock(&old->mutex);
-                usleep(200000);
-                continue;
             }
+        }
+        if (!next) {
+            next = room_neighbor(old, rng_range(&h->rng, 0, old->conn_count));
+        }
 
-            // Add to new room
-            pthread_mutex_lock(&h->current_room->mutex);
-            if (!room_add_hunter(h->current_room, h)) {
-                // Room full, go back
-                h->current_room = old;
-                room_add_hunter(old, h);
-            }
-            pthread_mutex_unlock(&h->current_room->mutex);
+        // Move in one step; a full room leaves the hunter where it was
+        if (room_transfer_hunter(old, next, h)) {
+            h->current_room = next;
+        }
 
-            log_move(h->id, h->boredom, h->fear, old->name, h->current_room->name, h->current_device);
+        log_move(h->id, h->boredom, h->fear, old->name, h->current_room->name, h->current_device);
 
-            // Push old room to breadcrumb stack if exploring
-            if (!returning_to_van) {
-                stack_push(&h->breadcrumb, old);
-            } else if (h->current_room->is_exit) {
-                returning_to_van = false;
+        // Push old room to breadcrumb stack if exploring
+        if (!h->returning_to_van) {
+            stack_push(&h->breadcrumb, old);
+        } else {
+            h->trip_ticks++;
+            if (h->current_room->is_exit) {
+                h->returning_to_van = false;
+                h->van_trips++;
+                h->van_trip_ticks += h->trip_ticks;
+                h->trip_ticks = 0;
             }
         }
-
-        usleep(200000); // 200ms delay
     }
 
-    // Log exit and clear breadcrumb stack
-    log_exit(h->id, h->boredom, h->fear, h->current_room->name, h->current_device, h->exit_reason);
-    stack_clear(&h->breadcrumb);
+    return true;
+}
+
+void* hunter_thread_fn(void* arg) {
+    struct Hunter* h = (struct Hunter*)arg;
+    if (!h || !h->current_room) return NULL;
+
+    struct House* house = h->current_room->house;
+    logger_set_run(house->log_run);
+    hunter_start(h);
+    simclock_schedule_start(&h->schedule, HUNTER_TICK_MS);
+    for (;;) {
+        // Snapshot before the tick reads the room, so a signal that lands
+        // while it runs still wakes the wait below
+        struct Room* room = h->current_room;
+        unsigned seen = house->reactive ? room_signal_seen(room, ROOM_SIGNAL_EVIDENCE) : 0;
+        if (!hunter_tick(h)) break;
+
+        struct timespec deadline;
+        simclock_schedule_next(&h->schedule, &deadline); // every 200ms, however long the tick took
+        if (house->reactive) {
+            // Tick again as soon as the ghost leaves something here. After a move the new room has not been read yet,
+            // so its generation as of now is the right starting point.
+            if (h->current_room != room) {
+                room = h->current_room;
+                seen = room_signal_seen(room, ROOM_SIGNAL_EVIDENCE);
+            }
+            room_wait_signal(room, ROOM_SIGNAL_EVIDENCE, seen, &deadline, &h->running);
+        } else {
+            simclock_sleep_until(&house->waker, &deadline, &h->running);
+        }
+    }
 
     return NULL;
 }
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef HUNTERRULES_H
+#define HUNTERRULES_H
+
+#include "defs.h"
+
+// The per-tick stat update (R-17) and the boredom/fear check (R-19) as inline
+// functions, so hunter_tick, the lockstep lanes and the layout benchmark all
+// apply exactly the same arithmetic.
+
+#define HUNTER_STAYS (-1)   // verdict of a hunter that passed R-19
+
+/**
+ * @brief R-17: adjust boredom and fear for the evidence in the hunter's room.
+ *        Any evidence means the ghost was here: boredom resets and fear rises,
+ *        by one more for EMF. An empty room adds boredom.
+ * @param[in] seen Evidence in the hunter's room this tick.
+ * @param[in,out] boredom Hunter's boredom.
+ * @param[in,out] fear Hunter's fear.
+ */
+static inline void hunter_rule_stats(EvidenceByte seen, int* boredom, int* fear) {
+    int present = seen != 0;
+    int emf = (seen & EV_EMF) != 0;
+    *boredom = present ? 0 : *boredom + 1;
+    *fear += present + emf;
+}
+
+/**
+ * @brief R-19: decide whether a hunter leaves, boredom taking precedence.
+ * @param[in] boredom Hunter's boredom after R-17.
+ * @param[in] fear Hunter's fear after R-17.
+ * @return LR_BORED, LR_AFRAID, or HUNTER_STAYS.
+ */
+static inline int hunter_rule_verdict(int boredom, int fear) {
+    // Arithmetic rather than a select chain so the store's loop vectorises
+    int bored = boredom >= ENTITY_BOREDOM_MAX;
+    int afraid = !bored & (fear >= HUNTER_FEAR_MAX);
+    return HUNTER_STAYS + bored * (LR_BORED - HUNTER_STAYS) + afraid * (LR_AFRAID - HUNTER_STAYS);
+}
+
+#endif // HUNTERRULES_H
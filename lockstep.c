@@ -0,0 +1,509 @@
+#include "lockstep.h"
+#include "hunterrules.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define NO_ROOM LOCKSTEP_MAX_ROOMS
+
+// Time advances in steps that both tick periods are whole multiples of
+#define STEP_MS 100
+_Static_assert(HUNTER_TICK_MS % STEP_MS == 0 && GHOST_TICK_MS % STEP_MS == 0, "tick periods must be whole steps");
+#define GHOST_STEPS (GHOST_TICK_MS / STEP_MS)
+#define HUNTER_STEPS (HUNTER_TICK_MS / STEP_MS)
+// Both tick kinds fall due together once per cycle; games start on a cycle
+// boundary so their first ghost and hunter ticks come at time 0
+#define CYCLE_STEPS (GHOST_STEPS * HUNTER_STEPS)
+
+// Multiversioned kernels: an AVX2 build and the baseline one, chosen when the
+// program loads
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__)
+#define LOCKSTEP_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define LOCKSTEP_KERNEL
+#endif
+
+// Lane helpers are folded into each kernel clone so they share its
+// instruction set and see constant bounds
+#if defined(__GNUC__)
+#define LOCKSTEP_INLINE static inline __attribute__((always_inline))
+#else
+#define LOCKSTEP_INLINE static inline
+#endif
+
+bool lockstep_parse_lanes(const char* text, int* lanes) {
+    if (!text || !lanes) return false;
+    char* end = NULL;
+    long value = strtol(text, &end, 10);
+    if (end == text || *end != '\0') return false;
+    if (value != 8 && value != 16 && value != 32) return false;
+    *lanes = (int)value;
+    return true;
+}
+
+// rng_below's rejection bound: draws whose low word falls under it are redrawn
+static uint32_t below_threshold(uint32_t bound) {
+    return bound ? (uint32_t)(-bound) % bound : 0;
+}
+
+// ---- Lane kernels ----
+// Every loop below runs over all lanes with 0/1 masks in place of branches
+// (a & ~b rather than a & !b, which gcc does not always if-convert),
+// and loads even for lanes that end up ignoring the value (all indices stay in
+// range), so the compiler can turn table lookups into gathers. The only
+// scalar loops are the few writes into per-room tables, which would be scatters.
+
+// rng_range(rng, 0, bound[l]) in every lane where take[l] is set; other lanes'
+// streams do not move. A rejected draw (probability below threshold / 2^32) is
+// finished afterwards with the scalar generator.
+LOCKSTEP_INLINE void lane_draw(struct LaneRng* rng, int lanes, const uint32_t* take, const uint32_t* bound,
+                             const uint32_t* threshold, uint32_t* out) {
+    uint32_t any_take = 0;
+    for (int l = 0; l < lanes; l++) any_take |= take[l];
+    if (!any_take) {
+        // Callers still index tables with the result
+        for (int l = 0; l < lanes; l++) out[l] = 0;
+        return;
+    }
+
+    uint32_t redo[LOCKSTEP_MAX_LANES];
+    uint32_t any_redo = 0;
+    for (int l = 0; l < lanes; l++) {
+        struct Rng stream = { rng->state[l], rng->inc[l] };
+        uint64_t product = (uint64_t)rng_next(&stream) * bound[l];
+        rng->state[l] = take[l] ? stream.state : rng->state[l];
+        out[l] = take[l] ? (uint32_t)(product >> 32) : 0;
+        redo[l] = take[l] & ((uint32_t)product < threshold[l]);
+        any_redo |= redo[l];
+    }
+    if (!any_redo) return;
+    for (int l = 0; l < lanes; l++) {
+        if (!redo[l]) continue;
+        struct Rng stream = { rng->state[l], rng->inc[l] };
+        uint64_t product;
+        do {
+            product = (uint64_t)rng_next(&stream) * bound[l];
+        } while ((uint32_t)product < threshold[l]);
+        rng->state[l] = stream.state;
+        out[l] = (uint32_t)(product >> 32);
+    }
+}
+
+// Same with one bound for every lane
+LOCKSTEP_INLINE void lane_draw_fixed(struct LaneRng* rng, int lanes, const uint32_t* take, uint32_t bound,
+                                   uint32_t* out) {
+    uint32_t bounds[LOCKSTEP_MAX_LANES];
+    uint32_t thresholds[LOCKSTEP_MAX_LANES];
+    uint32_t threshold = below_threshold(bound);
+    for (int l = 0; l < lanes; l++) {
+        bounds[l] = bound;
+        thresholds[l] = threshold;
+    }
+    lane_draw(rng, lanes, take, bounds, thresholds, out);
+}
+
+// table[index[l]] for every lane
+LOCKSTEP_INLINE void lane_table_read(const uint32_t* table, int lanes, const uint32_t* index, uint32_t* out) {
+    for (int l = 0; l < lanes; l++) out[l] = table[index[l]];
+}
+
+// table[room[l]][l] for every lane; the flat index is what gcc turns into a gather
+LOCKSTEP_INLINE void lane_room_read(const uint32_t (*table)[LOCKSTEP_MAX_LANES], int lanes, const uint32_t* room,
+                                    uint32_t* out) {
+    const uint32_t* flat = table[0];
+    for (int l = 0; l < lanes; l++) out[l] = flat[room[l] * LOCKSTEP_MAX_LANES + (uint32_t)l];
+}
+
+// ---- Ghost tick (ghost_tick) ----
+LOCKSTEP_KERNEL
+static void ghost_lanes(struct Lockstep* restrict ls, struct LaneGhost* restrict g, const uint32_t* due_in) {
+    int lanes = ls->lanes;
+    uint32_t shared = !ls->private_evidence;
+    uint32_t due[LOCKSTEP_MAX_LANES], act[LOCKSTEP_MAX_LANES], present[LOCKSTEP_MAX_LANES];
+    uint32_t occupancy[LOCKSTEP_MAX_LANES], draw[LOCKSTEP_MAX_LANES], take[LOCKSTEP_MAX_LANES];
+    uint32_t bound[LOCKSTEP_MAX_LANES], threshold[LOCKSTEP_MAX_LANES], placed[LOCKSTEP_MAX_LANES];
+
+    lane_room_read(ls->occupancy, lanes, g->room, occupancy);
+    for (int l = 0; l < lanes; l++) {
+        due[l] = due_in[l] & g->running[l];
+        ls->ticks[l] += due[l];
+        // Bored out on an earlier tick, or identified: stop without acting
+        uint32_t stop = due[l] & ((g->boredom[l] >= ENTITY_BOREDOM_MAX) | (shared & ls->solved[l]));
+        uint32_t go = due[l] & ~stop;
+        present[l] = occupancy[l] != 0;
+        g->loop_count[l] += (int32_t)go;
+        int32_t boredom = present[l] ? 0 : g->boredom[l] + 1;
+        g->boredom[l] = go ? boredom : g->boredom[l];
+        // Exit if bored, but not before the hunters had time to explore
+        uint32_t leave = go & (g->boredom[l] >= ENTITY_BOREDOM_MAX) & (g->loop_count[l] > 50);
+        g->running[l] &= ~(stop | leave);
+        act[l] = go & ~leave;
+    }
+
+    // Random action: 0 = idle, 1 = haunt, 2 = move
+    uint32_t action[LOCKSTEP_MAX_LANES];
+    lane_draw_fixed(&g->rng, lanes, act, 3, action);
+    for (int l = 0; l < lanes; l++) take[l] = act[l] & (action[l] == 1);
+    lane_draw_fixed(&g->rng, lanes, take, 7, draw);
+    for (int l = 0; l < lanes; l++) {
+        uint32_t bits = ls->evidence_types[draw[l]] & g->type[l];
+        placed[l] = take[l] ? bits : 0;
+    }
+    for (int l = 0; l < lanes; l++) ls->evidence[g->room[l]][l] |= placed[l];
+
+    // The ghost stays put while hunters are present, to scare them
+    for (int l = 0; l < lanes; l++) {
+        uint32_t room = g->room[l];
+        take[l] = act[l] & (action[l] == 2) & (ls->conn_count[room] > 0) & ~present[l];
+        bound[l] = ls->conn_count[room];
+        threshold[l] = ls->conn_threshold[room];
+    }
+    lane_draw(&g->rng, lanes, take, bound, threshold, draw);
+    for (int l = 0; l < lanes; l++) {
+        uint32_t next = ls->adj[ls->conn_first[g->room[l]] + draw[l]];
+        g->room[l] = take[l] ? next : g->room[l];
+    }
+}
+
+// ---- Hunter tick (hunter_tick) ----
+LOCKSTEP_KERNEL
+static void hunter_lanes(struct Lockstep* restrict ls, struct LaneHunter* restrict h, const uint32_t* due_in) {
+    int lanes = ls->lanes;
+    uint32_t shared = !ls->private_evidence;
+    uint32_t due[LOCKSTEP_MAX_LANES], gone[LOCKSTEP_MAX_LANES], reason[LOCKSTEP_MAX_LANES];
+    uint32_t go[LOCKSTEP_MAX_LANES], at_exit[LOCKSTEP_MAX_LANES], seen[LOCKSTEP_MAX_LANES];
+    uint32_t take[LOCKSTEP_MAX_LANES], draw[LOCKSTEP_MAX_LANES], act[LOCKSTEP_MAX_LANES];
+    uint32_t claimed[LOCKSTEP_MAX_LANES], next[LOCKSTEP_MAX_LANES], moved[LOCKSTEP_MAX_LANES];
+    uint32_t bound[LOCKSTEP_MAX_LANES], threshold[LOCKSTEP_MAX_LANES], walk[LOCKSTEP_MAX_LANES];
+
+    // Case closed: the team's combined evidence already names the ghost
+    for (int l = 0; l < lanes; l++) {
+        due[l] = due_in[l] & h->alive[l];
+        uint32_t closed = due[l] & shared & ls->solved[l];
+        h->returning[l] &= ~closed; // the trip is moot, not abandoned
+        gone[l] = closed;
+        reason[l] = LR_EVIDENCE;
+        go[l] = due[l] & ~closed;
+    }
+
+    // R-17: Update Stats (Ghost Check)
+    lane_room_read(ls->evidence, lanes, h->room, seen);
+    for (int l = 0; l < lanes; l++) {
+        int boredom = h->boredom[l];
+        int fear = h->fear[l];
+        hunter_rule_stats((EvidenceByte)seen[l], &boredom, &fear);
+        h->boredom[l] = go[l] ? boredom : h->boredom[l];
+        h->fear[l] = go[l] ? fear : h->fear[l];
+
+        // R-18: a hunter at the van with three kinds of evidence has won;
+        // otherwise it swaps device
+        at_exit[l] = ls->is_exit[h->room[l]];
+        uint32_t won = go[l] & at_exit[l] & ls->three_unique[h->collected[l]];
+        take[l] = go[l] & at_exit[l] & ~won;
+        gone[l] |= won;
+        go[l] &= ~won;
+    }
+    lane_draw_fixed(&h->rng, lanes, take, 7, draw);
+    for (int l = 0; l < lanes; l++) {
+        uint32_t device = ls->evidence_types[draw[l]];
+        device = take[l] ? device : h->device[l];
+        h->device[l] = device;
+
+        // R-19: Condition Check (Boredom / Fear)
+        int verdict = hunter_rule_verdict(h->boredom[l], h->fear[l]);
+        uint32_t leave = go[l] & (verdict != HUNTER_STAYS);
+        reason[l] = leave ? (uint32_t)verdict : reason[l];
+        gone[l] |= leave;
+        act[l] = go[l] & ~leave;
+
+        // R-20: claim what the device detects
+        claimed[l] = seen[l] & device & (0u - act[l]);
+    }
+    for (int l = 0; l < lanes; l++) ls->evidence[h->room[l]][l] &= ~claimed[l];
+    uint32_t solves[LOCKSTEP_MAX_LANES];
+    for (int l = 0; l < lanes; l++) {
+        uint32_t found = claimed[l] != 0;
+        h->collected[l] |= claimed[l];
+        ls->casefile[l] |= claimed[l] & (0u - shared);
+        h->returning[l] |= found & ~at_exit[l];
+        take[l] = act[l] & ~found;
+    }
+    lane_table_read(ls->solves, lanes, ls->casefile, solves);
+    for (int l = 0; l < lanes; l++) ls->solved[l] |= (claimed[l] != 0) & shared & solves[l];
+    // R-20.2: 20% chance to head back for another device, 30% more when the
+    // room holds evidence this device cannot see
+    lane_draw_fixed(&h->rng, lanes, take, 100, draw);
+    for (int l = 0; l < lanes; l++) {
+        h->returning[l] |= take[l] & (draw[l] < 20);
+        take[l] &= seen[l] != 0;
+    }
+    lane_draw_fixed(&h->rng, lanes, take, 100, draw);
+
+    // Movement: the exit route when returning, else an adjacent exit, else a
+    // random door
+    for (int l = 0; l < lanes; l++) {
+        h->returning[l] |= take[l] & (draw[l] < 30);
+        uint32_t room = h->room[l];
+        uint32_t moving = act[l] & (ls->conn_count[room] > 0);
+        uint32_t route = ls->exit_hop[room];
+        uint32_t door = ls->exit_door[room];
+        uint32_t hop = h->returning[l] & !ls->random_return ? route : NO_ROOM;
+        hop = (hop == NO_ROOM) & h->returning[l] ? door : hop;
+        walk[l] = moving & (hop == NO_ROOM);
+        next[l] = hop;
+        moved[l] = moving;
+        bound[l] = ls->conn_count[room];
+        threshold[l] = ls->conn_threshold[room];
+    }
+    lane_draw(&h->rng, lanes, walk, bound, threshold, draw);
+    for (int l = 0; l < lanes; l++) {
+        uint32_t door = ls->adj[ls->conn_first[h->room[l]] + draw[l]];
+        next[l] = walk[l] ? door : next[l];
+        next[l] = moved[l] ? next[l] : h->room[l];
+    }
+
+    // A full room leaves the hunter where it was
+    uint32_t fits[LOCKSTEP_MAX_LANES];
+    if (ls->room_limit > 0) {
+        lane_room_read(ls->occupancy, lanes, next, fits);
+        for (int l = 0; l < lanes; l++) fits[l] = fits[l] < (uint32_t)ls->room_limit;
+    } else {
+        for (int l = 0; l < lanes; l++) fits[l] = 1;
+    }
+    uint32_t entering[LOCKSTEP_MAX_LANES], leaving[LOCKSTEP_MAX_LANES];
+    for (int l = 0; l < lanes; l++) {
+        uint32_t trip = moved[l];
+        moved[l] = moved[l] & fits[l] & (next[l] != h->room[l]);
+        entering[l] = moved[l];
+        leaving[l] = (moved[l] | gone[l]) & h->listed[l];
+        walk[l] = trip;   // reused: the hunter took a movement step, even in place
+    }
+    for (int l = 0; l < lanes; l++) {
+        ls->occupancy[next[l]][l] += entering[l];
+        ls->occupancy[h->room[l]][l] -= leaving[l];
+    }
+
+    // Gathered apart from the loop below, whose stores into ls would
+    // otherwise stop gcc proving the gather independent
+    uint32_t in_exits[LOCKSTEP_MAX_LANES];
+    for (int l = 0; l < lanes; l++) {
+        uint32_t room = moved[l] ? next[l] : h->room[l];
+        h->room[l] = room;
+        in_exits[l] = ls->is_exit[room];
+    }
+    uint32_t step = ls->step;
+    for (int l = 0; l < lanes; l++) {
+        h->listed[l] = entering[l] | (h->listed[l] & ~gone[l]);
+
+        // Return trip bookkeeping
+        uint32_t in_exit = in_exits[l];
+        uint32_t homing = walk[l] & h->returning[l];
+        h->trip_ticks[l] += homing;
+        uint32_t arrived = homing & in_exit;
+        h->returning[l] &= ~arrived;
+        h->van_trips[l] += arrived;
+        h->van_trip_ticks[l] += h->trip_ticks[l] & (0u - arrived);
+        h->trip_ticks[l] &= arrived - 1u;
+
+        // Leaving the house (hunter_finish)
+        uint32_t abandoned = gone[l] & h->returning[l] & ~in_exit;
+        h->van_trips_abandoned[l] += abandoned;
+        h->van_trip_ticks[l] += h->trip_ticks[l] & (0u - abandoned);
+        h->exit_reason[l] ^= (h->exit_reason[l] ^ reason[l]) & (0u - gone[l]);
+        h->alive[l] &= ~gone[l];
+        ls->active[l] -= gone[l];
+        ls->last_exit[l] ^= (ls->last_exit[l] ^ step) & (0u - gone[l]);
+        ls->ticks[l] += due[l];
+    }
+}
+
+// ---- Games ----
+bool lockstep_init(struct Lockstep* ls, struct House* house, int lanes, struct Hunter* hunters, int hunter_count,
+                   struct Ghost* ghosts, int ghost_count, struct Arena* arena) {
+    const struct HouseMap* map = house->map;
+    if (house->room_count > LOCKSTEP_MAX_ROOMS || lanes < 1 || lanes > LOCKSTEP_MAX_LANES || hunter_count < 1 ||
+        ghost_count < 1) {
+        return false;
+    }
+
+    memset(ls, 0, sizeof(*ls));
+    ls->lanes = lanes;
+    ls->hunter_count = hunter_count;
+    ls->ghost_count = ghost_count;
+    ls->room_count = house->room_count;
+    ls->room_limit = house->room_count > 0 ? house->rooms[0].occupancy_limit : 0;
+    ls->private_evidence = house->private_evidence;
+    ls->random_return = house->random_return;
+    ls->house = house;
+    ls->setup_hunters = hunters;
+    ls->setup_ghosts = ghosts;
+
+    // One spare entry: a room without doors still has an in-range first door
+    ls->adj = arena_alloc(arena, ((size_t)map->adj_count + 1) * sizeof(*ls->adj), _Alignof(uint32_t));
+    ls->hunters = arena_alloc(arena, (size_t)hunter_count * sizeof(*ls->hunters), CACHE_LINE_SIZE);
+    ls->ghosts = arena_alloc(arena, (size_t)ghost_count * sizeof(*ls->ghosts), CACHE_LINE_SIZE);
+    if (!ls->adj || !ls->hunters || !ls->ghosts) return false;
+    memset(ls->hunters, 0, (size_t)hunter_count * sizeof(*ls->hunters));
+    memset(ls->ghosts, 0, (size_t)ghost_count * sizeof(*ls->ghosts));
+
+    for (uint32_t k = 0; k < map->adj_count; k++) {
+        ls->adj[k] = map_adj(map, k);
+    }
+    ls->adj[map->adj_count] = 0;
+    for (int r = 0; r < house->room_count; r++) {
+        struct Room* room = &house->rooms[r];
+        struct Room* hop = room_exit_hop(room);
+        ls->is_exit[r] = room->is_exit;
+        ls->conn_first[r] = room->conn_first;
+        ls->conn_count[r] = (uint32_t)room->conn_count;
+        ls->conn_threshold[r] = below_threshold((uint32_t)room->conn_count);
+        ls->exit_hop[r] = hop ? (uint32_t)(hop - house->rooms) : NO_ROOM;
+        ls->exit_door[r] = NO_ROOM;
+        for (int i = 0; i < room->conn_count; i++) {
+            struct Room* neighbor = room_neighbor(room, i);
+            if (neighbor->is_exit) {
+                ls->exit_door[r] = (uint32_t)(neighbor - house->rooms);
+                break;
+            }
+        }
+    }
+    for (int mask = 0; mask < EVIDENCE_MASK_COUNT; mask++) {
+        ls->solves[mask] = evidence_deduce((EvidenceByte)mask)->candidate_count == 1;
+        ls->three_unique[mask] = evidence_has_three_unique((EvidenceByte)mask);
+    }
+    const enum EvidenceType* evidence_types = NULL;
+    int evidence_count = get_all_evidence_types(&evidence_types);
+    for (int i = 0; i < evidence_count && i < 7; i++) {
+        ls->evidence_types[i] = (uint32_t)evidence_types[i];
+    }
+    return true;
+}
+
+// Set up the next game in one lane the way sim_setup_*, ghost_start and
+// hunter_start do
+static void lockstep_load(struct Lockstep* ls, int lane, uint64_t run_seed) {
+    struct House* house = ls->house;
+    sim_setup_ghosts(house, ls->setup_ghosts, ls->ghost_count, run_seed);
+    for (int i = 0; i < ls->ghost_count; i++) {
+        const struct Ghost* ghost = &ls->setup_ghosts[i];
+        struct LaneGhost* g = &ls->ghosts[i];
+        g->room[lane] = (uint32_t)(ghost->current_room - house->rooms);
+        g->boredom[lane] = 0;
+        g->loop_count[lane] = 0;
+        g->running[lane] = 1;
+        g->type[lane] = (uint32_t)ghost->type;
+        g->rng.state[lane] = ghost->rng.state;
+        g->rng.inc[lane] = ghost->rng.inc;
+    }
+
+    for (int r = 0; r < ls->room_count; r++) {
+        ls->evidence[r][lane] = 0;
+        ls->occupancy[r][lane] = 0;
+    }
+    for (int i = 0; i < ls->hunter_count; i++) {
+        struct Hunter* hunter = &ls->setup_hunters[i];
+        struct LaneHunter* h = &ls->hunters[i];
+        sim_setup_hunter(house, hunter, run_seed);
+        uint32_t room = (uint32_t)(hunter->current_room - house->rooms);
+
+        // R-16.3: Hunter starts with random device
+        h->device[lane] = ls->evidence_types[rng_range(&hunter->rng, 0, 7)];
+
+        // R-16.4: the van takes the hunter unless it is full
+        uint32_t listed = !ls->is_exit[room] || ls->room_limit == 0 ||
+                          ls->occupancy[room][lane] < (uint32_t)ls->room_limit;
+        ls->occupancy[room][lane] += listed;
+        h->listed[lane] = listed;
+        h->room[lane] = room;
+        h->boredom[lane] = 0;
+        h->fear[lane] = 0;
+        h->collected[lane] = 0;
+        h->returning[lane] = 0;
+        h->trip_ticks[lane] = 0;
+        h->alive[lane] = 1;
+        h->exit_reason[lane] = hunter->exit_reason;
+        h->van_trips[lane] = 0;
+        h->van_trip_ticks[lane] = 0;
+        h->van_trips_abandoned[lane] = 0;
+        h->rng.state[lane] = hunter->rng.state;
+        h->rng.inc[lane] = hunter->rng.inc;
+    }
+
+    ls->casefile[lane] = 0;
+    ls->solved[lane] = 0;
+    ls->live[lane] = 1;
+    ls->active[lane] = (uint32_t)ls->hunter_count;
+    ls->start[lane] = ls->step;
+    ls->last_exit[lane] = ls->step;
+    ls->ticks[lane] = 0;
+}
+
+// The SimResult summarise() would produce for one finished lane
+static void lockstep_result(const struct Lockstep* ls, int lane, struct SimResult* result) {
+    memset(result, 0, sizeof(*result));
+    result->ghost_type = (enum GhostType)ls->ghosts[0].type[lane];
+    result->case_solved = ls->solved[lane] != 0;
+    result->hunter_count = ls->hunter_count;
+    for (int i = 0; i < ls->hunter_count; i++) {
+        const struct LaneHunter* h = &ls->hunters[i];
+        result->total_evidence |= (EvidenceByte)h->collected[lane];
+        result->exit_counts[h->exit_reason[lane]]++;
+        result->van_trips += (int)h->van_trips[lane];
+        result->van_trip_ticks += (int)h->van_trip_ticks[lane];
+        result->van_trips_abandoned += (int)h->van_trips_abandoned[lane];
+        if (h->exit_reason[lane] == LR_EVIDENCE) result->ghost_caught = true;
+    }
+    EvidenceByte type = (EvidenceByte)result->ghost_type;
+    if ((result->total_evidence & type) == type) result->ghost_caught = true;
+    result->duration_ms = (long long)(uint32_t)(ls->last_exit[lane] - ls->start[lane]) * STEP_MS;
+    result->ticks = (long)ls->ticks[lane];
+}
+
+void lockstep_run(struct Lockstep* ls, const struct LockstepFeed* feed) {
+    int lanes = ls->lanes;
+    int live = 0;
+    bool more = true;
+    for (int l = 0; l < lanes; l++) {
+        uint64_t run_seed;
+        more = more && feed->next_game(feed->context, &run_seed);
+        ls->live[l] = more;
+        if (more) {
+            lockstep_load(ls, l, run_seed);
+            live++;
+        }
+    }
+
+    uint32_t due[LOCKSTEP_MAX_LANES];
+    while (live > 0) {
+        // One cycle of steps; steps where nothing is due are skipped
+        for (int phase = 0; phase < CYCLE_STEPS; phase++, ls->step++) {
+            bool ghosts_due = phase % GHOST_STEPS == 0;
+            bool hunters_due = phase % HUNTER_STEPS == 0;
+            if (!ghosts_due && !hunters_due) continue;
+            // A game whose hunters have all left is over, whatever its ghosts do
+            for (int l = 0; l < lanes; l++) due[l] = ls->live[l] & (ls->active[l] > 0);
+            if (ghosts_due) {
+                for (int i = 0; i < ls->ghost_count; i++) ghost_lanes(ls, &ls->ghosts[i], due);
+            }
+            if (hunters_due) {
+                for (int i = 0; i < ls->hunter_count; i++) hunter_lanes(ls, &ls->hunters[i], due);
+            }
+        }
+
+        // Report finished games and refill their lanes
+        for (int l = 0; l < lanes; l++) {
+            if (!ls->live[l] || ls->active[l] > 0) continue;
+            struct SimResult result;
+            lockstep_result(ls, l, &result);
+            feed->finished(feed->context, &result);
+
+            uint64_t run_seed;
+            more = more && feed->next_game(feed->context, &run_seed);
+            if (more) {
+                lockstep_load(ls, l, run_seed);
+            } else {
+                ls->live[l] = 0;
+                live--;
+            }
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#ifndef LOCKSTEP_H
+#define LOCKSTEP_H
+
+#include "helpers.h"
+#include "sim.h"
+#include <stdint.h>
+
+// Many independent games advanced together, one game per lane. Every per-game
+// value (a room's evidence, a hunter's fear, a ghost's room, ...) is an array
+// indexed by lane, and each tick phase is a straight loop over the lanes with
+// the branches turned into masks, so the compiler runs 4-8 games per
+// instruction (gcc needs -O3; on x86-64 the hot kernels are also built for
+// AVX2 and picked at run time, with the SSE2 or scalar code as fallback).
+//
+// Lanes follow the event engine exactly: time advances in steps of the
+// greatest common divisor of the tick periods, ghosts tick before hunters
+// that are due at the same moment, hunters tick in index order, and every
+// entity draws from its own stream in the same order as ghost_tick and
+// hunter_tick. A game therefore plays out move for move as it would on the
+// event engine, and a batch produces the same statistics. A lane whose game
+// ends is refilled with the next game at the start of the next tick cycle.
+
+#define LOCKSTEP_MAX_LANES 32
+#define LOCKSTEP_DEFAULT_LANES 16
+#define LOCKSTEP_MAX_ROOMS 32      // per-room tables are [room][lane]
+
+// One random stream per lane
+struct LaneRng {
+    uint64_t state[LOCKSTEP_MAX_LANES];
+    uint64_t inc[LOCKSTEP_MAX_LANES];
+};
+
+// One hunter of every lane's game; flags are 0 or 1
+struct LaneHunter {
+    uint32_t room[LOCKSTEP_MAX_LANES];
+    int32_t boredom[LOCKSTEP_MAX_LANES];
+    int32_t fear[LOCKSTEP_MAX_LANES];
+    uint32_t collected[LOCKSTEP_MAX_LANES];
+    uint32_t device[LOCKSTEP_MAX_LANES];
+    uint32_t returning[LOCKSTEP_MAX_LANES];
+    uint32_t trip_ticks[LOCKSTEP_MAX_LANES];
+    uint32_t alive[LOCKSTEP_MAX_LANES];
+    uint32_t listed[LOCKSTEP_MAX_LANES];      // counted in its room's occupancy
+    uint32_t exit_reason[LOCKSTEP_MAX_LANES];
+    uint32_t van_trips[LOCKSTEP_MAX_LANES];
+    uint32_t van_trip_ticks[LOCKSTEP_MAX_LANES];
+    uint32_t van_trips_abandoned[LOCKSTEP_MAX_LANES];
+    struct LaneRng rng;
+};
+
+// One ghost of every lane's game
+struct LaneGhost {
+    uint32_t room[LOCKSTEP_MAX_LANES];
+    int32_t boredom[LOCKSTEP_MAX_LANES];
+    int32_t loop_count[LOCKSTEP_MAX_LANES];
+    uint32_t running[LOCKSTEP_MAX_LANES];
+    uint32_t type[LOCKSTEP_MAX_LANES];
+    struct LaneRng rng;
+};
+
+// Where games come from and where their results go
+struct LockstepFeed {
+    bool (*next_game)(void* context, uint64_t* run_seed);   // false once no games are left
+    void (*finished)(void* context, const struct SimResult* result);
+    void* context;
+};
+
+struct Lockstep {
+    int lanes;
+    int hunter_count;
+    int ghost_count;
+    int room_count;
+    int room_limit;                  // hunters per room, 0 = unlimited
+    bool private_evidence;
+    bool random_return;
+    struct House* house;             // sets games up; its rooms are never touched during play
+    struct Hunter* setup_hunters;    // scratch entities for sim_setup_*, ids and names kept
+    struct Ghost* setup_ghosts;
+
+    // Layout of the house, flattened to one word per room
+    uint32_t is_exit[LOCKSTEP_MAX_ROOMS];
+    uint32_t conn_first[LOCKSTEP_MAX_ROOMS];
+    uint32_t conn_count[LOCKSTEP_MAX_ROOMS];
+    uint32_t conn_threshold[LOCKSTEP_MAX_ROOMS];  // rng_below rejection bound for conn_count
+    uint32_t exit_hop[LOCKSTEP_MAX_ROOMS];        // room_exit_hop, LOCKSTEP_MAX_ROOMS if none
+    uint32_t exit_door[LOCKSTEP_MAX_ROOMS];       // first adjacent exit, LOCKSTEP_MAX_ROOMS if none
+    uint32_t* adj;
+    uint32_t solves[EVIDENCE_MASK_COUNT];         // mask leaves exactly one candidate ghost
+    uint32_t three_unique[EVIDENCE_MASK_COUNT];   // evidence_has_three_unique
+    uint32_t evidence_types[7];
+
+    // Per-lane game state
+    uint32_t evidence[LOCKSTEP_MAX_ROOMS][LOCKSTEP_MAX_LANES];
+    uint32_t occupancy[LOCKSTEP_MAX_ROOMS][LOCKSTEP_MAX_LANES];
+    uint32_t casefile[LOCKSTEP_MAX_LANES];
+    uint32_t solved[LOCKSTEP_MAX_LANES];
+    uint32_t live[LOCKSTEP_MAX_LANES];            // lane holds a game in progress
+    uint32_t active[LOCKSTEP_MAX_LANES];          // hunters still in the house
+    uint32_t step;                                // shared clock, wraps
+    uint32_t start[LOCKSTEP_MAX_LANES];           // step the lane's game began
+    uint32_t last_exit[LOCKSTEP_MAX_LANES];       // step of the latest hunter exit
+    uint32_t ticks[LOCKSTEP_MAX_LANES];
+    struct LaneHunter* hunters;
+    struct LaneGhost* ghosts;
+};
+
+/**
+ * @brief Parse a lane count (8, 16 or 32).
+ * @param[in] text Lane count text.
+ * @param[out] lanes Parsed value.
+ * @return true when the count is supported.
+ */
+bool lockstep_parse_lanes(const char* text, int* lanes);
+
+/**
+ * @brief Prepare lockstep play for one worker. The house supplies the layout,
+ *        room capacity and rule switches (random_return, private_evidence).
+ * @param[out] ls State to set up.
+ * @param[in] house House built by house_init; must outlive ls.
+ * @param[in] lanes Games played at once, 1..LOCKSTEP_MAX_LANES.
+ * @param[in,out] hunters Hunter ids and names to play with; used as setup scratch.
+ * @param[in] hunter_count Hunters per game, at least 1.
+ * @param[in,out] ghosts Setup scratch for ghost_count ghosts.
+ * @param[in] ghost_count Ghosts per game, at least 1.
+ * @param[in,out] arena Holds the lane entities; must outlive ls.
+ * @return false when the house has more than LOCKSTEP_MAX_ROOMS rooms or memory runs out.
+ */
+bool lockstep_init(struct Lockstep* ls, struct House* house, int lanes, struct Hunter* hunters, int hunter_count,
+                   struct Ghost* ghosts, int ghost_count, struct Arena* arena);
+
+/**
+ * @brief Play games from the feed until it runs dry, reporting each result as
+ *        its game ends (not in feed order). Results match sim_run on the
+ *        event engine except that no log records are written.
+ * @param[in,out] ls State from lockstep_init.
+ * @param[in] feed Game source and result sink.
+ */
+void lockstep_run(struct Lockstep* ls, const struct LockstepFeed* feed);
+
+#endif // LOCKSTEP_H
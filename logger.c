@@ -0,0 +1,728 @@
+#include "logger.h"
+#include "simclock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+
+// One open file plus its pending output. Each entity logs from a single thread,
+// so the writer mutex is uncontended in practice; it only guards against the
+// main thread flushing while the entity is still appending.
+struct LogWriter {
+    int entity_id;
+    long long run;              // batch game index, LOG_NO_RUN for the interactive game
+    int fd;
+    pthread_mutex_t mutex;
+    char buffer[LOG_BUFFER_SIZE];
+    size_t length;
+    long long last_timestamp;   // monotonic tie-breaker: timestamps strictly increase per file
+    long long last_flush_ms;
+    unsigned line_count;
+    bool capped;                // hit LOG_LINE_CAP; the rest of the game is not logged
+    struct LogWriter* next_free;
+};
+
+// Open-addressing table of writers keyed by entity id and run (power-of-two capacity).
+// The spare table has the same capacity; close_run_writers rebuilds into it and swaps.
+static struct LogWriter** writers = NULL;
+static struct LogWriter** spare_writers = NULL;
+static int writer_capacity = 0;
+static int writer_count = 0;
+static struct LogWriter* free_writers = NULL; // closed writers kept for the next game's files
+static atomic_long allocation_count;
+static atomic_uint writer_generation = 1; // bumped under table_mutex, read lock-free by writer_for
+static bool logger_enabled = true;
+static bool exit_hook_installed = false;
+static pthread_mutex_t table_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Threads usually log for one entity only; remember it to skip the table lock
+static _Thread_local struct LogWriter* cached_writer = NULL;
+static _Thread_local unsigned cached_generation = 0;
+static _Thread_local long long current_run = LOG_NO_RUN;
+
+// ---- Async pipeline state ----
+
+// Queued in place of a record to close a game's files once its records are written
+#define LOG_EVENT_END_RUN 0xFF
+
+// Fixed-size queued event: strings are replaced by interned indices (0 = empty)
+struct LogEvent {
+    long long timestamp;
+    long long run;
+    int entity_id;
+    int boredom;
+    int fear;
+    uint32_t room;
+    uint32_t device;
+    uint32_t action;
+    uint32_t extra;
+    unsigned char entity_type;
+};
+
+// Bounded MPSC ring (Vyukov-style): a cell is free for ticket t when
+// sequence == t and holds data for the consumer when sequence == t + 1.
+struct LogCell {
+    atomic_size_t sequence;
+    struct LogEvent event;
+};
+
+static struct LogCell* queue = NULL;
+static size_t queue_mask = 0;
+static atomic_size_t enqueue_pos;
+static atomic_size_t dequeue_pos;
+static enum LogBackpressure queue_policy = LOG_BP_BLOCK;
+static atomic_bool async_running = false;
+static atomic_bool writer_stop = false;
+static atomic_bool writer_idle = false;
+static atomic_size_t high_water;
+static atomic_ulong dropped_count;
+static atomic_ulong blocked_count;
+static pthread_t writer_thread;
+static pthread_mutex_t wake_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wake_cond = PTHREAD_COND_INITIALIZER;   // writer waits for data
+static pthread_cond_t space_cond = PTHREAD_COND_INITIALIZER;  // producers wait for room
+
+// Lock-free intern table: slots are published once with CAS and never change
+// until shutdown, so the slot number doubles as the string's stable index.
+static _Atomic(char*)* intern_slots = NULL;
+static atomic_ulong intern_overflow;
+
+static const char* log_entity_type_to_string(enum LogEntityType type) {
+    switch (type) {
+        case LOG_ENTITY_HUNTER:
+            return "hunter";
+        case LOG_ENTITY_GHOST:
+            return "ghost";
+        default:
+            return "unknown";
+    }
+}
+
+// ---- Writer table ----
+static unsigned hash_id(int id, long long run) {
+    unsigned x = (unsigned)id ^ ((unsigned)run * 0x9E3779B9u);
+    x ^= x >> 16;
+    x *= 0x45d9f3bu;
+    x ^= x >> 16;
+    return x;
+}
+
+static void table_insert(struct LogWriter** table, int capacity, struct LogWriter* writer) {
+    unsigned slot = hash_id(writer->entity_id, writer->run) & (unsigned)(capacity - 1);
+    while (table[slot]) {
+        slot = (slot + 1) & (unsigned)(capacity - 1);
+    }
+    table[slot] = writer;
+}
+
+static bool table_grow(void) {
+    int new_capacity = writer_capacity ? writer_capacity * 2 : 16;
+    struct LogWriter** table = calloc((size_t)new_capacity, sizeof(*table));
+    struct LogWriter** spare = calloc((size_t)new_capacity, sizeof(*spare));
+    if (!table || !spare) {
+        free(table);
+        free(spare);
+        return false;
+    }
+    atomic_fetch_add_explicit(&allocation_count, 2, memory_order_relaxed);
+
+    for (int i = 0; i < writer_capacity; i++) {
+        if (writers[i]) table_insert(table, new_capacity, writers[i]);
+    }
+    free(writers);
+    free(spare_writers);
+    writers = table;
+    spare_writers = spare;
+    writer_capacity = new_capacity;
+    return true;
+}
+
+// Caller holds table_mutex
+static struct LogWriter* table_find(int entity_id, long long run) {
+    if (writer_capacity == 0) return NULL;
+    unsigned slot = hash_id(entity_id, run) & (unsigned)(writer_capacity - 1);
+    while (writers[slot]) {
+        if (writers[slot]->entity_id == entity_id && writers[slot]->run == run) return writers[slot];
+        slot = (slot + 1) & (unsigned)(writer_capacity - 1);
+    }
+    return NULL;
+}
+
+static void flush_locked(struct LogWriter* writer) {
+    size_t offset = 0;
+    while (offset < writer->length) {
+        ssize_t written = write(writer->fd, writer->buffer + offset, writer->length - offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            break; // Disk error: drop the buffer rather than spin
+        }
+        offset += (size_t)written;
+    }
+    writer->length = 0;
+}
+
+static void logger_atexit(void) {
+    logger_shutdown();
+}
+
+static struct LogWriter* writer_for(int entity_id, long long run) {
+    unsigned generation = atomic_load_explicit(&writer_generation, memory_order_acquire);
+    if (cached_writer && cached_generation == generation && cached_writer->entity_id == entity_id &&
+        cached_writer->run == run) {
+        return cached_writer;
+    }
+
+    pthread_mutex_lock(&table_mutex);
+    struct LogWriter* writer = table_find(entity_id, run);
+    if (!writer) {
+        // Keep load factor under one half
+        if ((writer_count + 1) * 2 > writer_capacity && !table_grow()) {
+            pthread_mutex_unlock(&table_mutex);
+            return NULL;
+        }
+
+        char filename[64];
+        if (run == LOG_NO_RUN) {
+            snprintf(filename, sizeof(filename), "log_%d.csv", entity_id);
+        } else {
+            snprintf(filename, sizeof(filename), "log_%d_run%lld.csv", entity_id, run);
+        }
+        int fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) {
+            pthread_mutex_unlock(&table_mutex);
+            return NULL;
+        }
+        if (free_writers) {
+            writer = free_writers;
+            free_writers = writer->next_free;
+        } else {
+            writer = malloc(sizeof(*writer));
+            if (!writer) {
+                close(fd);
+                pthread_mutex_unlock(&table_mutex);
+                return NULL;
+            }
+            atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+            pthread_mutex_init(&writer->mutex, NULL);
+        }
+
+        writer->entity_id = entity_id;
+        writer->run = run;
+        writer->fd = fd;
+        writer->length = 0;
+        writer->last_timestamp = 0;
+        writer->last_flush_ms = simclock_wall_ms();
+        writer->line_count = 0;
+        writer->capped = false;
+        table_insert(writers, writer_capacity, writer);
+        writer_count++;
+
+        if (!exit_hook_installed) {
+            atexit(logger_atexit);
+            exit_hook_installed = true;
+        }
+    }
+    cached_writer = writer;
+    cached_generation = writer_generation;
+    pthread_mutex_unlock(&table_mutex);
+    return writer;
+}
+
+// Format one line into the writer's buffer. An entity that reaches
+// LOG_LINE_CAP in one game stops logging for the rest of that game.
+static void append_line(const struct LogRecord* record, long long run, long long now) {
+    struct LogWriter* writer = writer_for(record->entity_id, run);
+    if (!writer) return;
+
+    pthread_mutex_lock(&writer->mutex);
+
+    if (writer->line_count >= LOG_LINE_CAP) {
+        if (!writer->capped) {
+            writer->capped = true;
+            fprintf(stderr, "Log capped for entity %d (run %lld) at %d lines; dropping the rest of its log.\n",
+                    record->entity_id, run, LOG_LINE_CAP);
+        }
+        pthread_mutex_unlock(&writer->mutex);
+        return;
+    }
+
+    long long timestamp = now > writer->last_timestamp ? now : writer->last_timestamp + 1;
+    writer->last_timestamp = timestamp;
+
+    const char* entity = log_entity_type_to_string(record->entity_type);
+    const char* room = record->room ? record->room : "";
+    const char* device = record->device ? record->device : "";
+    const char* action = record->action ? record->action : "";
+    const char* extra = record->extra ? record->extra : "";
+
+    char line[512];
+    int length = snprintf(line, sizeof(line),
+                          "%lld,%s,%d,%s,%s,%d,%d,%s,%s\n",
+                          timestamp,
+                          entity,
+                          record->entity_id,
+                          room,
+                          device,
+                          record->boredom,
+                          record->fear,
+                          action,
+                          extra);
+    if (length < 0) {
+        pthread_mutex_unlock(&writer->mutex);
+        return;
+    }
+    if ((size_t)length >= sizeof(line)) {
+        length = (int)sizeof(line) - 1;
+        line[length - 1] = '\n';
+    }
+
+    long long wall = simclock_wall_ms();
+    if (writer->length + (size_t)length > sizeof(writer->buffer)) {
+        flush_locked(writer);
+        writer->last_flush_ms = wall;
+    }
+    memcpy(writer->buffer + writer->length, line, (size_t)length);
+    writer->length += (size_t)length;
+    writer->line_count++;
+
+    if (wall - writer->last_flush_ms >= LOG_FLUSH_INTERVAL_MS) {
+        flush_locked(writer);
+        writer->last_flush_ms = wall;
+    }
+
+    pthread_mutex_unlock(&writer->mutex);
+}
+
+static void close_writer(struct LogWriter* writer) {
+    close(writer->fd);
+    pthread_mutex_destroy(&writer->mutex);
+    free(writer);
+}
+
+// Caller holds table_mutex
+static void free_writer_list(void) {
+    while (free_writers) {
+        struct LogWriter* next = free_writers->next_free;
+        pthread_mutex_destroy(&free_writers->mutex);
+        free(free_writers);
+        free_writers = next;
+    }
+}
+
+// Flush and close the writers of one batch game. The writers and their
+// buffers go on the free list, so later games open files without malloc.
+static void close_run_writers(long long run) {
+    pthread_mutex_lock(&table_mutex);
+    if (writer_capacity == 0) {
+        pthread_mutex_unlock(&table_mutex);
+        return;
+    }
+    struct LogWriter** kept = spare_writers;
+    memset(kept, 0, (size_t)writer_capacity * sizeof(*kept));
+    for (int i = 0; i < writer_capacity; i++) {
+        struct LogWriter* writer = writers[i];
+        if (!writer) continue;
+        if (writer->run != run) {
+            table_insert(kept, writer_capacity, writer);
+            continue;
+        }
+        pthread_mutex_lock(&writer->mutex);
+        flush_locked(writer);
+        pthread_mutex_unlock(&writer->mutex);
+        close(writer->fd);
+        writer->next_free = free_writers;
+        free_writers = writer;
+        writer_count--;
+    }
+    spare_writers = writers;
+    writers = kept;
+    atomic_fetch_add_explicit(&writer_generation, 1, memory_order_release); // invalidates every thread's cached_writer
+    pthread_mutex_unlock(&table_mutex);
+}
+
+static void flush_all_writers(bool close_files) {
+    pthread_mutex_lock(&table_mutex);
+    for (int i = 0; i < writer_capacity; i++) {
+        struct LogWriter* writer = writers[i];
+        if (!writer) continue;
+        pthread_mutex_lock(&writer->mutex);
+        flush_locked(writer);
+        writer->last_flush_ms = simclock_wall_ms();
+        pthread_mutex_unlock(&writer->mutex);
+        if (close_files) close_writer(writer);
+    }
+    if (close_files) {
+        free_writer_list();
+        free(writers);
+        free(spare_writers);
+        writers = NULL;
+        spare_writers = NULL;
+        writer_capacity = 0;
+        writer_count = 0;
+        atomic_fetch_add_explicit(&writer_generation, 1, memory_order_release); // invalidates every thread's cached_writer
+    }
+    pthread_mutex_unlock(&table_mutex);
+}
+
+// ---- String interning ----
+static unsigned hash_string(const char* text) {
+    unsigned h = 2166136261u; // FNV-1a
+    for (const unsigned char* p = (const unsigned char*)text; *p; p++) {
+        h = (h ^ *p) * 16777619u;
+    }
+    return h;
+}
+
+static uint32_t intern(const char* text) {
+    if (!text || !*text) return 0;
+
+    unsigned mask = LOG_INTERN_CAPACITY - 1;
+    unsigned slot = hash_string(text) & mask;
+    if (slot == 0) slot = 1; // index 0 means ""
+    char* copy = NULL;
+
+    for (unsigned probes = 0; probes < LOG_INTERN_CAPACITY; probes++) {
+        char* current = atomic_load_explicit(&intern_slots[slot], memory_order_acquire);
+        if (!current) {
+            if (!copy) {
+                copy = strdup(text);
+                if (!copy) break;
+                atomic_fetch_add_explicit(&allocation_count, 1, memory_order_relaxed);
+            }
+            char* expected = NULL;
+            if (atomic_compare_exchange_strong_explicit(&intern_slots[slot], &expected, copy,
+                                                        memory_order_acq_rel, memory_order_acquire)) {
+                return slot;
+            }
+            current = expected; // another thread published this slot first
+        }
+        if (strcmp(current, text) == 0) {
+            free(copy);
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+        if (slot == 0) slot = 1;
+    }
+
+    free(copy);
+    atomic_fetch_add_explicit(&intern_overflow, 1, memory_order_relaxed);
+    return 0;
+}
+
+static const char* intern_lookup(uint32_t index) {
+    if (index == 0) return "";
+    const char* text = atomic_load_explicit(&intern_slots[index], memory_order_acquire);
+    return text ? text : "";
+}
+
+// ---- MPSC queue ----
+static void note_depth(size_t depth) {
+    if (depth > queue_mask + 1) depth = queue_mask + 1; // dequeue_pos may be read stale
+    size_t seen = atomic_load_explicit(&high_water, memory_order_relaxed);
+    while (depth > seen &&
+           !atomic_compare_exchange_weak_explicit(&high_water, &seen, depth,
+                                                  memory_order_relaxed, memory_order_relaxed)) {
+    }
+}
+
+static void wake_writer(void) {
+    // Pairs with the fence in writer_thread_fn: either we see writer_idle or it sees our cell
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&writer_idle, memory_order_relaxed)) {
+        pthread_mutex_lock(&wake_mutex);
+        pthread_cond_signal(&wake_cond);
+        pthread_mutex_unlock(&wake_mutex);
+    }
+}
+
+// Claim a cell and publish the event. Returns false when the queue is full.
+static bool queue_try_push(const struct LogEvent* event) {
+    size_t pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+    for (;;) {
+        struct LogCell* cell = &queue[pos & queue_mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&enqueue_pos, &pos, pos + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->event = *event;
+                atomic_store_explicit(&cell->sequence, pos + 1, memory_order_release);
+                note_depth(pos + 1 - atomic_load_explicit(&dequeue_pos, memory_order_relaxed));
+                return true;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = atomic_load_explicit(&enqueue_pos, memory_order_relaxed);
+        }
+    }
+}
+
+// Single consumer: no CAS needed on dequeue_pos
+static bool queue_try_pop(struct LogEvent* event) {
+    size_t pos = atomic_load_explicit(&dequeue_pos, memory_order_relaxed);
+    struct LogCell* cell = &queue[pos & queue_mask];
+    size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+    if (sequence != pos + 1) return false;
+
+    *event = cell->event;
+    atomic_store_explicit(&cell->sequence, pos + queue_mask + 1, memory_order_release);
+    atomic_store_explicit(&dequeue_pos, pos + 1, memory_order_release);
+    return true;
+}
+
+// Queue an event; under LOG_BP_DROP a full queue discards it unless it must arrive
+static void enqueue_event(const struct LogEvent* event, bool may_drop) {
+    if (queue_try_push(event)) {
+        wake_writer();
+        return;
+    }
+
+    if (may_drop && queue_policy == LOG_BP_DROP) {
+        atomic_fetch_add_explicit(&dropped_count, 1, memory_order_relaxed);
+        return;
+    }
+
+    atomic_fetch_add_explicit(&blocked_count, 1, memory_order_relaxed);
+    pthread_mutex_lock(&wake_mutex);
+    while (!queue_try_push(event)) {
+        pthread_cond_signal(&wake_cond);
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += 1000000; // re-check every 1 ms in case a wakeup was missed
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&space_cond, &wake_mutex, &deadline);
+    }
+    pthread_cond_signal(&wake_cond);
+    pthread_mutex_unlock(&wake_mutex);
+}
+
+static void enqueue_record(const struct LogRecord* record) {
+    struct LogEvent event = {
+        .timestamp = simclock_now_ms(),
+        .run = current_run,
+        .entity_id = record->entity_id,
+        .boredom = record->boredom,
+        .fear = record->fear,
+        .room = intern(record->room),
+        .device = intern(record->device),
+        .action = intern(record->action),
+        .extra = intern(record->extra),
+        .entity_type = (unsigned char)record->entity_type
+    };
+
+    enqueue_event(&event, true);
+}
+
+// Resolve interned indices back to text and append the CSV line
+static void write_event(const struct LogEvent* event) {
+    if (event->entity_type == LOG_EVENT_END_RUN) {
+        close_run_writers(event->run);
+        return;
+    }
+    struct LogRecord record = {
+        .entity_type = (enum LogEntityType)event->entity_type,
+        .entity_id = event->entity_id,
+        .room = intern_lookup(event->room),
+        .device = intern_lookup(event->device),
+        .boredom = event->boredom,
+        .fear = event->fear,
+        .action = intern_lookup(event->action),
+        .extra = intern_lookup(event->extra)
+    };
+    append_line(&record, event->run, event->timestamp);
+}
+
+static void* writer_thread_fn(void* arg) {
+    (void)arg;
+    struct LogEvent event;
+
+    for (;;) {
+        int drained = 0;
+        while (queue_try_pop(&event)) {
+            write_event(&event);
+            if (++drained % 64 == 0 && queue_policy == LOG_BP_BLOCK) {
+                pthread_mutex_lock(&wake_mutex);
+                pthread_cond_broadcast(&space_cond);
+                pthread_mutex_unlock(&wake_mutex);
+            }
+        }
+        if (drained && queue_policy == LOG_BP_BLOCK) {
+            pthread_mutex_lock(&wake_mutex);
+            pthread_cond_broadcast(&space_cond);
+            pthread_mutex_unlock(&wake_mutex);
+        }
+
+        if (atomic_load_explicit(&writer_stop, memory_order_acquire)) {
+            // Producers are gone; one more pass catches anything published late
+            if (!queue_try_pop(&event)) break;
+            write_event(&event);
+            continue;
+        }
+
+        // Idle: sleep until a producer signals, waking periodically for the time-based flush
+        pthread_mutex_lock(&wake_mutex);
+        atomic_store_explicit(&writer_idle, true, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        struct LogCell* next = &queue[atomic_load_explicit(&dequeue_pos, memory_order_relaxed) & queue_mask];
+        if (atomic_load_explicit(&next->sequence, memory_order_acquire) !=
+                atomic_load_explicit(&dequeue_pos, memory_order_relaxed) + 1 &&
+            !atomic_load_explicit(&writer_stop, memory_order_acquire)) {
+            struct timespec deadline;
+            clock_gettime(CLOCK_REALTIME, &deadline);
+            deadline.tv_nsec += (long)LOG_FLUSH_INTERVAL_MS * 1000000L;
+            while (deadline.tv_nsec >= 1000000000L) {
+                deadline.tv_sec++;
+                deadline.tv_nsec -= 1000000000L;
+            }
+            if (pthread_cond_timedwait(&wake_cond, &wake_mutex, &deadline) != 0) {
+                pthread_mutex_unlock(&wake_mutex);
+                atomic_store_explicit(&writer_idle, false, memory_order_release);
+                flush_all_writers(false);
+                continue;
+            }
+        }
+        atomic_store_explicit(&writer_idle, false, memory_order_release);
+        pthread_mutex_unlock(&wake_mutex);
+    }
+
+    return NULL;
+}
+
+// ---- Public API ----
+void logger_set_enabled(bool enabled) {
+    logger_enabled = enabled;
+}
+
+bool logger_parse_backpressure(const char* name, enum LogBackpressure* policy) {
+    if (!name || !policy) return false;
+    if (strcmp(name, "block") == 0) {
+        *policy = LOG_BP_BLOCK;
+        return true;
+    }
+    if (strcmp(name, "drop") == 0) {
+        *policy = LOG_BP_DROP;
+        return true;
+    }
+    return false;
+}
+
+bool logger_start_async(enum LogBackpressure policy, size_t capacity) {
+    if (atomic_load(&async_running)) return true;
+
+    size_t slots = 2;
+    if (capacity == 0) capacity = LOG_QUEUE_DEFAULT_CAPACITY;
+    if (capacity > LOG_QUEUE_MAX_CAPACITY) capacity = LOG_QUEUE_MAX_CAPACITY;
+    while (slots < capacity) slots <<= 1;
+
+    queue = malloc(slots * sizeof(*queue));
+    intern_slots = calloc(LOG_INTERN_CAPACITY, sizeof(*intern_slots));
+    if (!queue || !intern_slots) {
+        free(queue);
+        free(intern_slots);
+        queue = NULL;
+        intern_slots = NULL;
+        return false;
+    }
+    for (size_t i = 0; i < slots; i++) {
+        atomic_init(&queue[i].sequence, i);
+    }
+    queue_mask = slots - 1;
+    queue_policy = policy;
+    atomic_store(&enqueue_pos, 0);
+    atomic_store(&dequeue_pos, 0);
+    atomic_store(&high_water, 0);
+    atomic_store(&dropped_count, 0);
+    atomic_store(&blocked_count, 0);
+    atomic_store(&intern_overflow, 0);
+    atomic_store(&writer_stop, false);
+
+    if (pthread_create(&writer_thread, NULL, writer_thread_fn, NULL) != 0) {
+        free(queue);
+        free(intern_slots);
+        queue = NULL;
+        intern_slots = NULL;
+        return false;
+    }
+    atomic_store(&async_running, true);
+
+    if (!exit_hook_installed) {
+        atexit(logger_atexit);
+        exit_hook_installed = true;
+    }
+    return true;
+}
+
+void logger_write(const struct LogRecord* record) {
+    if (!logger_enabled || !record) return;
+
+    if (atomic_load_explicit(&async_running, memory_order_acquire)) {
+        enqueue_record(record);
+        return;
+    }
+
+    append_line(record, current_run, simclock_now_ms());
+}
+
+void logger_set_run(long long run) {
+    current_run = run;
+}
+
+void logger_end_run(long long run) {
+    if (!logger_enabled || run == LOG_NO_RUN) return;
+    if (atomic_load_explicit(&async_running, memory_order_acquire)) {
+        struct LogEvent event = { .run = run, .entity_type = LOG_EVENT_END_RUN };
+        enqueue_event(&event, false);
+        return;
+    }
+    close_run_writers(run);
+}
+
+void logger_flush_all(void) {
+    flush_all_writers(false);
+}
+
+long logger_allocations(void) {
+    return atomic_load_explicit(&allocation_count, memory_order_relaxed);
+}
+
+void logger_shutdown(void) {
+    if (atomic_exchange(&async_running, false)) {
+        atomic_store_explicit(&writer_stop, true, memory_order_release);
+        pthread_mutex_lock(&wake_mutex);
+        pthread_cond_signal(&wake_cond);
+        pthread_mutex_unlock(&wake_mutex);
+        if (!pthread_equal(pthread_self(), writer_thread)) {
+            pthread_join(writer_thread, NULL);
+        }
+
+        fprintf(stderr,
+                "Log queue: capacity %zu, high-water %zu, dropped %lu, blocked enqueues %lu",
+                queue_mask + 1,
+                atomic_load(&high_water),
+                atomic_load(&dropped_count),
+                atomic_load(&blocked_count));
+        if (atomic_load(&intern_overflow)) {
+            fprintf(stderr, ", intern overflow %lu", atomic_load(&intern_overflow));
+        }
+        fprintf(stderr, "\n");
+
+        for (unsigned i = 0; i < LOG_INTERN_CAPACITY; i++) {
+            free(atomic_load(&intern_slots[i]));
+        }
+        free(intern_slots);
+        free(queue);
+        intern_slots = NULL;
+        queue = NULL;
+    }
+
+    flush_all_writers(true);
+}
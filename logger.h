@@ -0,0 +1,110 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// CSV log sink. Every entity keeps one open log_<id>.csv for the whole run and
+// records are buffered in memory until a size/time threshold or shutdown.
+// Games of a batch log to log_<id>_run<k>.csv instead, one file per entity
+// and game, closed when the game ends.
+// In async mode entity threads only enqueue a fixed-size event; a dedicated
+// writer thread formats and writes the CSV lines.
+
+#define LOG_BUFFER_SIZE (64 * 1024)   // bytes buffered per entity before a write()
+#define LOG_FLUSH_INTERVAL_MS 250     // oldest unflushed record is written after this
+#define LOG_LINE_CAP 100000           // hard cap on lines per entity file; later lines are dropped
+#define LOG_NO_RUN (-1LL)             // run tag of the interactive game
+#define LOG_QUEUE_DEFAULT_CAPACITY 8192
+#define LOG_QUEUE_MAX_CAPACITY (1 << 24) // largest queue --log-queue accepts, in slots
+#define LOG_INTERN_CAPACITY (1 << 17) // distinct strings the async mode can intern
+
+enum LogEntityType {
+    LOG_ENTITY_HUNTER = 0,
+    LOG_ENTITY_GHOST = 1
+};
+
+// What an entity thread does when the async queue is full
+enum LogBackpressure {
+    LOG_BP_BLOCK = 0,   // wait for the writer thread to make room
+    LOG_BP_DROP = 1     // discard the record and count it
+};
+
+struct LogRecord {
+    enum LogEntityType entity_type;
+    int                entity_id;
+    const char*        room;
+    const char*        device;
+    int                boredom;
+    int                fear;
+    const char*        action;
+    const char*        extra;
+};
+
+/**
+ * @brief Enable or disable writing CSV files (enabled by default).
+ * @param[in] enabled false turns logger_write into a no-op.
+ */
+void logger_set_enabled(bool enabled);
+
+/**
+ * @brief Switch to asynchronous logging with a dedicated writer thread.
+ * @param[in] policy Behaviour when the queue is full.
+ * @param[in] capacity Queue slots, rounded up to a power of two (0 = default,
+ *            at most LOG_QUEUE_MAX_CAPACITY).
+ * @return true when the writer thread is running.
+ */
+bool logger_start_async(enum LogBackpressure policy, size_t capacity);
+
+/**
+ * @brief Parse a backpressure policy name ("block" or "drop").
+ * @param[in] name Policy text.
+ * @param[out] policy Parsed value.
+ * @return true when the name is recognised.
+ */
+bool logger_parse_backpressure(const char* name, enum LogBackpressure* policy);
+
+/**
+ * @brief Format one record as a CSV line and append it to the entity's buffer.
+ *        In async mode the strings are interned and the record is queued instead.
+ * @param[in] record Record to write; NULL string fields are written empty.
+ */
+void logger_write(const struct LogRecord* record);
+
+/**
+ * @brief Tag the records the calling thread writes from now on with a batch
+ *        game index, which picks the files they go to.
+ * @param[in] run Game index, or LOG_NO_RUN for the interactive game.
+ */
+void logger_set_run(long long run);
+
+/**
+ * @brief Flush and close the files of one batch game once its entities have
+ *        stopped logging. In async mode the files close after the queued
+ *        records of the game are written.
+ * @param[in] run Game index passed to logger_set_run.
+ */
+void logger_end_run(long long run);
+
+/**
+ * @brief Write every buffered line to disk without closing the files.
+ */
+void logger_flush_all(void);
+
+/**
+ * @brief Count the malloc calls the logger has made for file writers, its
+ *        writer table and interned strings. Writers are recycled between
+ *        games, so the count stops growing once the first games have logged.
+ * @return Allocations made since the program started.
+ */
+long logger_allocations(void);
+
+/**
+ * @brief Flush and close every entity file. Safe to call more than once.
+ *        In async mode the queue is drained first, the writer thread is joined
+ *        and queue statistics (high-water mark, drops, blocked enqueues) are
+ *        printed to stderr.
+ */
+void logger_shutdown(void);
+
+#endif // LOGGER_H
@@ -7,44 +7,332 @@
 #include <time.h>
 #include <semaphore.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
 
 #include "defs.h"
 #include "helpers.h"
+#include "logger.h"
+#include "sim.h"
+#include "runner.h"
+#include "bench.h"
+#include "map.h"
+#include "lockstep.h"
+#include "estimate.h"
+#include "converge.h"
 
-// Forward declarations (threads)
-void* ghost_thread_fn(void* arg);
-void* hunter_thread_fn(void* arg);
+#define DEFAULT_TEAM_SIZE 4   // hunters prompted for interactively and used by default in batch mode
+#define DEFAULT_SOLVE_PRECISION 0.5   // seconds, for --precision batches
 
-// ---------- Main ----------
-int main() {
-    struct House house;
-    house_populate_rooms(&house);
+// Command-line options. Any of --hunters/--runs/--seed/--roster selects batch mode.
+struct Options {
+    bool batch;
+    int hunters;
+    int runs;
+    bool runs_set;
+    bool seed_set;
+    uint64_t seed;
+    uint64_t first_run;
+    int workers;
+    bool scaling;
+    const char* roster;
+    const char* bench;
+    bool estimate;
+    double precision;         // win-rate half-width in percentage points, 0 = fixed --runs
+    double solve_precision;   // time-to-solve half-width in seconds
+    int ghosts;
+    int room_capacity;
+    const char* map_path;
+    int generate_rooms;
+    uint64_t map_seed;
+    const char* save_map;
+    bool random_return;
+    bool private_evidence;
+    bool reactive;
+    int pool_workers;
+    int lanes;
+    bool engine_set;
+    enum SimEngine engine;
+    bool csv_logs;
+    bool async_log;
+    enum LogBackpressure log_policy;
+    int log_queue;
+};
 
-    // initialize casefile and house mutex
-    house.casefile.collected = 0;
-    house.casefile.solved = false;
-    sem_init(&house.casefile.mutex, 0, 1);
-    pthread_mutex_init(&house.house_mutex, NULL);
+static void print_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  (no options)             interactive game, hunters read from stdin\n"
+            "  --hunters N              batch mode: N hunters per game (default %d)\n"
+            "  --runs M                 batch mode: play M games back to back\n"
+            "  --seed S                 batch mode: base random seed\n"
+            "  --first-run K            batch mode: start at game index K of the seed\n"
+            "  --roster FILE            batch mode: hunters as '<id> <name>' lines\n"
+            "  --log                    batch mode: also write log_<id>_run<k>.csv files\n"
+            "  --workers N              batch mode: worker threads (default: all cores)\n"
+            "  --scaling                batch mode: time the batch with 1..N workers\n"
+            "  --precision P            batch mode: play until every ghost type's win rate\n"
+            "                           is known to +-P percentage points (95%%), with\n"
+            "                           --runs M as the cap (default %ld)\n"
+            "  --solve-precision S      with --precision: also the mean time to solve to\n"
+            "                           +-S seconds (default %.1f, 0 = win rate only)\n"
+            "  --ghosts G               ghosts per game (default 1, all of one type)\n"
+            "  --room-capacity N        hunters allowed per room (default %d, 0 = unlimited)\n"
+            "  --map FILE               play in a house map file (text or binary) instead of Willow\n"
+            "  --generate-map N         play in a generated house of N rooms\n"
+            "  --map-seed S             layout seed for --generate-map (default 1)\n"
+            "  --save-map FILE          write the house map (text if FILE ends in .txt, else\n"
+            "                           binary) and exit unless a batch option is given\n"
+            "  --random-return          returning hunters wander instead of taking the\n"
+            "                           shortest route to the van (for comparison)\n"
+            "  --private-evidence       hunters keep evidence to themselves instead of\n"
+            "                           solving the case together (for comparison)\n"
+            "  --reactive               threads engine: hunters wake the moment evidence\n"
+            "                           appears and ghosts when a hunter enters, instead\n"
+            "                           of only on their fixed tick (low-latency experiments)\n"
+            "  --bench NAME             run a benchmark ('--bench list' shows them)\n"
+            "  --estimate               win rate and game length per ghost from a Markov\n"
+            "                           chain instead of playing; with --runs M also plays\n"
+            "                           M games and compares\n"
+            "  --engine threads|events|pool|lockstep\n"
+            "                           real-time threads (interactive default),\n"
+            "                           virtual-clock events (batch default), real time\n"
+            "                           with entities multiplexed over a worker pool, or\n"
+            "                           event-engine games played side by side in SIMD lanes\n"
+            "  --pool-workers N         pool engine: worker threads per game (default: all cores)\n"
+            "  --lanes 8|16|32          lockstep engine: games played at once per worker (default %d)\n"
+            "  --async-log[=block|drop] write CSV logs from a background thread\n"
+            "  --log-queue N            async log queue capacity, 1..%d slots (default %d)\n",
+            program, DEFAULT_TEAM_SIZE, CONVERGE_DEFAULT_MAX_RUNS, DEFAULT_SOLVE_PRECISION, MAX_ROOM_OCCUPANCY,
+            LOCKSTEP_DEFAULT_LANES, LOG_QUEUE_MAX_CAPACITY, LOG_QUEUE_DEFAULT_CAPACITY);
+}
 
-    // Ghost init
-    struct Ghost ghost;
-    ghost.id = DEFAULT_GHOST_ID;
-    const enum GhostType* ghost_types = NULL;
-    int g_count = get_all_ghost_types(&ghost_types);
-    if (g_count <= 0) {
-        fprintf(stderr, "No ghost types available\n");
-        return 1;
+static bool parse_int_arg(const char* text, int minimum, int* out) {
+    char* end = NULL;
+    long value = strtol(text, &end, 10);
+    if (!text[0] || *end != '\0' || value < minimum || value > 1000000000L) return false;
+    *out = (int)value;
+    return true;
+}
+
+static bool parse_u64_arg(const char* text, uint64_t* out) {
+    char* end = NULL;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    // strtoull accepts a sign and wraps negative values around; seeds are plain digits
+    if (!text[0] || text[0] == '-' || text[0] == '+' || *end != '\0' || errno == ERANGE) return false;
+    *out = (uint64_t)value;
+    return true;
+}
+
+static bool parse_double_arg(const char* text, double minimum, double* out) {
+    char* end = NULL;
+    double value = strtod(text, &end);
+    if (!text[0] || *end != '\0' || !(value >= minimum) || value > 1e9) return false;
+    *out = value;
+    return true;
+}
+
+static bool parse_options(int argc, char** argv, struct Options* options) {
+    memset(options, 0, sizeof(*options));
+    options->runs = 1;
+    options->solve_precision = DEFAULT_SOLVE_PRECISION;
+    options->ghosts = 1;
+    options->room_capacity = MAX_ROOM_OCCUPANCY;
+    options->map_seed = 1;
+    options->log_policy = LOG_BP_BLOCK;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--hunters") == 0 && value) {
+            if (!parse_int_arg(value, 1, &options->hunters)) return false;
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--runs") == 0 && value) {
+            if (!parse_int_arg(value, 1, &options->runs)) return false;
+            options->runs_set = true;
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && value) {
+            if (!parse_u64_arg(value, &options->seed)) return false;
+            options->seed_set = true;
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--first-run") == 0 && value) {
+            if (!parse_u64_arg(value, &options->first_run)) return false;
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--roster") == 0 && value) {
+            options->roster = value;
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--ghosts") == 0 && value) {
+            if (!parse_int_arg(value, 1, &options->ghosts)) return false;
+            i++;
+        } else if (strcmp(arg, "--room-capacity") == 0 && value) {
+            if (!parse_int_arg(value, 0, &options->room_capacity)) return false;
+            i++;
+        } else if (strcmp(arg, "--map") == 0 && value) {
+            options->map_path = value;
+            i++;
+        } else if (strcmp(arg, "--generate-map") == 0 && value) {
+            if (!parse_int_arg(value, 2, &options->generate_rooms)) return false;
+            i++;
+        } else if (strcmp(arg, "--map-seed") == 0 && value) {
+            if (!parse_u64_arg(value, &options->map_seed)) return false;
+            i++;
+        } else if (strcmp(arg, "--save-map") == 0 && value) {
+            options->save_map = value;
+            i++;
+        } else if (strcmp(arg, "--random-return") == 0) {
+            options->random_return = true;
+        } else if (strcmp(arg, "--private-evidence") == 0) {
+            options->private_evidence = true;
+        } else if (strcmp(arg, "--reactive") == 0) {
+            options->reactive = true;
+        } else if (strcmp(arg, "--pool-workers") == 0 && value) {
+            if (!parse_int_arg(value, 1, &options->pool_workers)) return false;
+            i++;
+        } else if (strcmp(arg, "--lanes") == 0 && value) {
+            if (!lockstep_parse_lanes(value, &options->lanes)) {
+                fprintf(stderr, "Invalid lane count '%s' (use 8, 16 or 32)\n", value);
+                return false;
+            }
+            i++;
+        } else if (strcmp(arg, "--workers") == 0 && value) {
+            if (!parse_int_arg(value, 1, &options->workers)) return false;
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--scaling") == 0) {
+            options->scaling = true;
+            options->batch = true;
+        } else if (strcmp(arg, "--precision") == 0 && value) {
+            if (!parse_double_arg(value, CONVERGE_MIN_WIN_POINTS, &options->precision)) {
+                fprintf(stderr, "--precision must be at least %.2f percentage points\n", CONVERGE_MIN_WIN_POINTS);
+                return false;
+            }
+            options->batch = true;
+            i++;
+        } else if (strcmp(arg, "--solve-precision") == 0 && value) {
+            if (!parse_double_arg(value, 0.0, &options->solve_precision)) return false;
+            i++;
+        } else if (strcmp(arg, "--engine") == 0 && value) {
+            if (!sim_parse_engine(value, &options->engine)) {
+                fprintf(stderr, "Unknown engine '%s' (use threads, events, pool or lockstep)\n", value);
+                return false;
+            }
+            options->engine_set = true;
+            i++;
+        } else if (strcmp(arg, "--bench") == 0 && value) {
+            options->bench = value;
+            i++;
+        } else if (strcmp(arg, "--estimate") == 0) {
+            options->estimate = true;
+        } else if (strcmp(arg, "--log") == 0) {
+            options->csv_logs = true;
+        } else if (strncmp(arg, "--async-log", 11) == 0 && (arg[11] == '\0' || arg[11] == '=')) {
+            options->async_log = true;
+            if (arg[11] == '=' && !logger_parse_backpressure(arg + 12, &options->log_policy)) {
+                fprintf(stderr, "Unknown backpressure policy '%s' (use block or drop)\n", arg + 12);
+                return false;
+            }
+        } else if (strcmp(arg, "--log-queue") == 0 && value) {
+            if (!parse_int_arg(value, 1, &options->log_queue) || options->log_queue > LOG_QUEUE_MAX_CAPACITY) {
+                fprintf(stderr, "--log-queue takes 1..%d slots\n", LOG_QUEUE_MAX_CAPACITY);
+                return false;
+            }
+            i++;
+        } else {
+            return false;
+        }
     }
-    ghost.type = ghost_types[rand_int_threadsafe(0, g_count)];
-    ghost.current_room = &house.rooms[rand_int_threadsafe(0, house.room_count)];
-    ghost.running = true;
 
-    // Hunters input
-    struct Hunter hunters[4];
+    if (options->map_path && options->generate_rooms) {
+        fprintf(stderr, "--map and --generate-map are mutually exclusive\n");
+        return false;
+    }
+    if (options->precision > 0.0 && options->scaling) {
+        fprintf(stderr, "--precision and --scaling are mutually exclusive\n");
+        return false;
+    }
+    if (!options->seed_set) {
+        options->seed = (uint64_t)time(NULL);
+    }
+    if (!options->engine_set) {
+        options->engine = options->batch ? SIM_ENGINE_EVENTS : SIM_ENGINE_THREADS;
+    }
+    if (options->reactive && options->engine != SIM_ENGINE_THREADS) {
+        fprintf(stderr, "--reactive only changes the threads engine; add --engine threads\n");
+        return false;
+    }
+    return true;
+}
+
+// ---------- Hunter setup ----------
+static void set_hunter_identity(struct Hunter* h, int id, const char* name) {
+    h->id = id;
+    snprintf(h->name, sizeof(h->name), "%s", name);
+}
+
+// Read '<id> <name>' lines (all of them when max_hunters is 0) into a growing array;
+// blank lines and '#' comments are skipped
+static int read_roster(const char* path, int max_hunters, struct Hunter** out) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return -1;
+    }
+
+    struct Hunter* hunters = NULL;
+    int count = 0;
+    int capacity = 0;
+    char line[256];
+    while ((max_hunters == 0 || count < max_hunters) && fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = 0;
+        char* cursor = line;
+        while (*cursor == ' ' || *cursor == '\t') cursor++;
+        if (*cursor == '\0' || *cursor == '#') continue;
+
+        char* end = NULL;
+        long id = strtol(cursor, &end, 10);
+        if (end == cursor) {
+            fprintf(stderr, "%s: expected '<id> <name>', got '%s'\n", path, line);
+            free(hunters);
+            fclose(file);
+            return -1;
+        }
+        while (*end == ' ' || *end == '\t' || *end == ',') end++;
+
+        if (count == capacity) {
+            capacity = capacity ? capacity * 2 : DEFAULT_TEAM_SIZE;
+            struct Hunter* grown = realloc(hunters, (size_t)capacity * sizeof(*grown));
+            if (!grown) {
+                free(hunters);
+                fclose(file);
+                return -1;
+            }
+            hunters = grown;
+        }
+
+        char fallback[MAX_HUNTER_NAME];
+        snprintf(fallback, sizeof(fallback), "Hunter %ld", id);
+        set_hunter_identity(&hunters[count], (int)id, *end ? end : fallback);
+        count++;
+    }
+
+    fclose(file);
+    *out = hunters;
+    return count;
+}
+
+// Interactive prompt used when no batch options are given
+static int read_hunters_from_stdin(struct Hunter* hunters, int max_hunters) {
     int hunter_count = 0;
     char name[MAX_HUNTER_NAME];
     int id;
-    while (hunter_count < 4) {
+    while (hunter_count < max_hunters) {
         printf("Enter hunter %d name (or 'done'): ", hunter_count + 1);
         if (!fgets(name, sizeof(name), stdin)) break;
         name[strcspn(name, "\n")] = 0;
@@ -54,57 +342,18 @@ int main() {
         if (scanf("%d", &id) != 1) break;
         while (getchar() != '\n'); // flush newline
 
-        struct Hunter* h = &hunters[hunter_count];
-        h->id = id;
-        strncpy(h->name, name, MAX_HUNTER_NAME - 1);
-        h->name[MAX_HUNTER_NAME - 1] = '\0';
-        h->current_room = house.starting_room;
-        h->boredom = 0;
-        h->fear = 0;
-        h->collected = 0;
+        set_hunter_identity(&hunters[hunter_count], id, name);
         hunter_count++;
     }
+    return hunter_count;
+}
 
-    if (hunter_count == 0) {
-        printf("No hunters provided. Exiting.\n");
-        sem_destroy(&house.casefile.mutex);
-        pthread_mutex_destroy(&house.house_mutex);
-        return 0;
-    }
-
-    // Start ghost thread first
-    if (pthread_create(&ghost.thread, NULL, ghost_thread_fn, &ghost) != 0) {
-        perror("Failed to create ghost thread");
-        sem_destroy(&house.casefile.mutex);
-        pthread_mutex_destroy(&house.house_mutex);
-        return 1;
-    }
-
-    // Start ALL hunter threads at once (they will run concurrently with each other and the ghost)
-    for (int i = 0; i < hunter_count; i++) {
-        if (pthread_create(&hunters[i].thread, NULL, hunter_thread_fn, &hunters[i]) != 0) {
-            perror("Failed to create hunter thread");
-            // If a thread creation fails, mark remaining as not created (you may want to handle cleanup more thoroughly)
-            hunter_count = i;
-            break;
-        }
-    
-    }
-
-    // Wait for ALL hunter threads to finish
-    for (int i = 0; i < hunter_count; i++) {
-        pthread_join(hunters[i].thread, NULL);
-    }
-
-    // After all hunters finish, stop the ghost and join it
-    ghost.running = false;
-    pthread_join(ghost.thread, NULL);
-
+// ---------- Reporting ----------
+static void print_final_results(const struct Hunter* hunters, int hunter_count, const struct SimResult* result) {
     // Collect results
     printf("\nSimulation Results:\n");
 
-    bool ghost_caught = false;
-    EvidenceByte total_evidence = 0;
+    EvidenceByte total_evidence = result->total_evidence;
 
     //Go through each hunters stats for the game
     for (int i = 0; i < hunter_count; i++) {
@@ -112,22 +361,13 @@ int main() {
                hunters[i].name, hunters[i].id,
                exit_reason_to_string(hunters[i].exit_reason),
                hunters[i].collected);
-
-        total_evidence |= hunters[i].collected;
-        if (hunters[i].exit_reason == LR_EVIDENCE) {
-            ghost_caught = true;
-        }
     }
 
     printf("\n=== FINAL RESULTS ===\n");
-    printf("Ghost type: %s\n", ghost_to_string(ghost.type));
+    printf("Ghost type: %s\n", ghost_to_string(result->ghost_type));
     printf("Total evidence collected: 0x%02X\n", total_evidence);
 
-    if ((total_evidence & (EvidenceByte)ghost.type) == ghost.type) {
-        ghost_caught = true;
-    }
-
-    if (ghost_caught){
+    if (result->ghost_caught){
         printf("🎉 GHOST CAUGHT! The hunters successfully identified the ghost.");
     } else {
         printf("\n❌ Ghost escaped! Analysis of collected evidence:\n");
@@ -150,25 +390,27 @@ int main() {
         // Check potential ghost matches
         printf("\nPotential ghosts based on evidence:\n");
         const enum GhostType* all_ghost_types = NULL;
-        int ghost_count = get_all_ghost_types(&all_ghost_types);
+        get_all_ghost_types(&all_ghost_types);
+        const struct EvidenceDeduction* deduction = evidence_deduce(total_evidence);
         bool matches_found = false;
 
-        for (int i = 0; i < ghost_count; i++) {
-            if ((total_evidence & (EvidenceByte)all_ghost_types[i]) == total_evidence && total_evidence != 0) {
-                printf("  - %s (requires: ", ghost_to_string(all_ghost_types[i]));
-
-                bool first_ev = true;
-                for (int j = 0; j < 7; j++) {
-                    enum EvidenceType ev = 1 << j;
-                    if (all_ghost_types[i] & ev) {
-                        if (!first_ev) printf(", ");
-                        printf("%s", evidence_to_string(ev));
-                        first_ev = false;
-                    }
+        // Every ghost fits "no evidence"; only list candidates once something was found
+        uint32_t candidates = total_evidence != 0 ? deduction->candidates : 0;
+        for (; candidates; candidates &= candidates - 1) {
+            int i = __builtin_ctz(candidates);
+            printf("  - %s (requires: ", ghost_to_string(all_ghost_types[i]));
+
+            bool first_ev = true;
+            for (int j = 0; j < 7; j++) {
+                enum EvidenceType ev = 1 << j;
+                if (all_ghost_types[i] & ev) {
+                    if (!first_ev) printf(", ");
+                    printf("%s", evidence_to_string(ev));
+                    first_ev = false;
                 }
-                printf(")\n");
-                matches_found = true;
             }
+            printf(")\n");
+            matches_found = true;
         }
 
         if (!matches_found) {
@@ -177,11 +419,11 @@ int main() {
         }
 
         // Show what evidence the actual ghost leaves
-        printf("\nThe actual ghost (%s) leaves evidence: ", ghost_to_string(ghost.type));
+        printf("\nThe actual ghost (%s) leaves evidence: ", ghost_to_string(result->ghost_type));
         bool first_real = true;
         for (int i = 0; i < 7; i++) {
             enum EvidenceType ev = 1 << i;
-            if (ghost.type & ev) {
+            if (result->ghost_type & ev) {
                 if (!first_real) printf(", ");
                 printf("%s", evidence_to_string(ev));
                 first_real = false;
@@ -190,7 +432,316 @@ int main() {
         printf("\n");
     }
 
-    sem_destroy(&house.casefile.mutex);
-    pthread_mutex_destroy(&house.house_mutex);
+}
+
+// ---------- Modes ----------
+
+// Replay the same batch with 1, 2, 4, ... workers up to the configured count
+static bool run_scaling(const struct RunnerConfig* base) {
+    printf("\n=== SCALING (%ld runs per step) ===\n", base->runs);
+    printf("%8s %12s %14s %9s %11s\n", "workers", "elapsed(s)", "runs/sec", "speedup", "efficiency");
+
+    double baseline = 0.0;
+    long baseline_wins = -1;
+    bool identical = true;
+    for (int workers = 1; ; workers = workers * 2 < base->workers ? workers * 2 : base->workers) {
+        struct RunnerConfig config = *base;
+        config.workers = workers;
+
+        struct BatchStats stats;
+        double seconds = 0.0;
+        if (!runner_run(&config, &stats, &seconds)) return false;
+
+        double rate = seconds > 0 ? stats.runs / seconds : 0.0;
+        if (workers == 1) baseline = rate;
+        if (baseline_wins < 0) baseline_wins = stats.wins;
+        identical = identical && stats.wins == baseline_wins;
+
+        double speedup = baseline > 0 ? rate / baseline : 0.0;
+        printf("%8d %12.3f %14.1f %8.2fx %10.1f%%\n", workers, seconds, rate, speedup, 100.0 * speedup / workers);
+        if (workers >= base->workers) break;
+    }
+    printf("Results identical across worker counts: %s\n", identical ? "yes" : "NO");
+    return true;
+}
+
+// Hunters 1..count named "Hunter <id>"
+static struct Hunter* default_team(int hunter_count) {
+    struct Hunter* hunters = calloc((size_t)hunter_count, sizeof(*hunters));
+    if (!hunters) {
+        perror("Failed to allocate hunters");
+        return NULL;
+    }
+    for (int i = 0; i < hunter_count; i++) {
+        char name[MAX_HUNTER_NAME];
+        snprintf(name, sizeof(name), "Hunter %d", i + 1);
+        set_hunter_identity(&hunters[i], i + 1, name);
+    }
+    return hunters;
+}
+
+static int run_batch(const struct Options* options, const struct HouseMap* map) {
+    struct Hunter* hunters = NULL;
+    int hunter_count;
+
+    if (options->roster) {
+        hunter_count = read_roster(options->roster, options->hunters, &hunters);
+        if (hunter_count < 0) return 1;
+    } else {
+        hunter_count = options->hunters ? options->hunters : DEFAULT_TEAM_SIZE;
+        hunters = default_team(hunter_count);
+        if (!hunters) return 1;
+    }
+    if (hunter_count == 0) {
+        fprintf(stderr, "No hunters provided. Exiting.\n");
+        free(hunters);
+        return 1;
+    }
+
+    struct RunnerConfig config = {
+        .workers = options->workers,
+        .runs = options->runs,
+        .seed = options->seed,
+        .first_run = options->first_run,
+        .engine = options->engine,
+        .roster = hunters,
+        .hunter_count = hunter_count,
+        .ghost_count = options->ghosts,
+        .room_capacity = options->room_capacity,
+        .map = map,
+        .random_return = options->random_return,
+        .private_evidence = options->private_evidence,
+        .reactive = options->reactive,
+        .pool_workers = options->pool_workers,
+        .lanes = options->lanes
+    };
+    if (config.workers == 0) {
+        // Real-time games mostly sleep; only virtual-clock games benefit from every core
+        bool virtual_time = options->engine == SIM_ENGINE_EVENTS || options->engine == SIM_ENGINE_LOCKSTEP;
+        config.workers = virtual_time ? runner_default_workers() : 1;
+    }
+
+    if (options->scaling) {
+        bool ok = run_scaling(&config);
+        free(hunters);
+        return ok ? 0 : 1;
+    }
+
+    struct BatchStats stats;
+    double seconds = 0.0;
+    struct ConvergeConfig target = {
+        .win_points = options->precision,
+        .solve_ms = options->solve_precision * 1000.0,
+        .max_runs = options->runs_set ? options->runs : CONVERGE_DEFAULT_MAX_RUNS
+    };
+    struct Convergence convergence;
+    bool converging = options->precision > 0.0;
+    bool ok = converging ? converge_run(&config, &target, &stats, &convergence, &seconds)
+                         : runner_run(&config, &stats, &seconds);
+    free(hunters);
+    if (!ok) {
+        return 1;
+    }
+
+    printf("\n=== BATCH SUMMARY ===\n");
+    printf("Runs: %ld  Hunters per run: %d  Ghosts per run: %d  Workers: %d  Seed: %llu (first run %llu)\n",
+           stats.runs, hunter_count, options->ghosts, config.workers,
+           (unsigned long long)options->seed, (unsigned long long)options->first_run);
+    if (map) {
+        printf("House: %s (%u rooms, %u doors)\n",
+               options->map_path ? options->map_path : "generated", map->room_count, map->adj_count / 2);
+    }
+    batch_stats_print(&stats, options->engine == SIM_ENGINE_EVENTS || options->engine == SIM_ENGINE_LOCKSTEP);
+    if (converging) converge_print(&convergence, &target, &stats);
+    printf("\nElapsed: %.3f s, throughput: %.2f runs/sec\n", seconds, seconds > 0 ? stats.runs / seconds : 0.0);
+    return 0;
+}
+
+// Markov-chain estimate, checked against played games when --runs asks for more than one
+static int run_estimate(const struct Options* options, const struct HouseMap* map) {
+    if (options->private_evidence) {
+        fprintf(stderr, "The estimator models the shared case file only; drop --private-evidence\n");
+        return 1;
+    }
+    if (options->reactive) {
+        fprintf(stderr, "The estimator models fixed ticks only; drop --reactive\n");
+        return 1;
+    }
+    int hunter_count = options->hunters ? options->hunters : DEFAULT_TEAM_SIZE;
+    if (options->room_capacity > 0 && options->room_capacity < hunter_count) {
+        fprintf(stderr, "Note: the estimator assumes rooms never fill (capacity %d, %d hunters)\n",
+                options->room_capacity, hunter_count);
+    }
+
+    struct EstimateConfig estimate_config = {
+        .map = map,
+        .hunter_count = hunter_count,
+        .ghost_count = options->ghosts,
+        .random_return = options->random_return
+    };
+    struct timespec began, ended;
+    clock_gettime(CLOCK_MONOTONIC, &began);
+    struct Estimate estimate;
+    if (!estimate_run(&estimate_config, &estimate)) {
+        fprintf(stderr, "Failed to build the Markov chain\n");
+        return 1;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &ended);
+    double estimate_ms = (double)(ended.tv_sec - began.tv_sec) * 1e3 + (double)(ended.tv_nsec - began.tv_nsec) / 1e6;
+
+    if (options->runs <= 1) {
+        estimate_print(&estimate, NULL);
+        printf("\nEstimated in %.1f ms\n", estimate_ms);
+        return 0;
+    }
+
+    struct Hunter* hunters = default_team(hunter_count);
+    if (!hunters) return 1;
+    struct RunnerConfig config = {
+        .workers = options->workers ? options->workers : runner_default_workers(),
+        .runs = options->runs,
+        .seed = options->seed,
+        .first_run = options->first_run,
+        .engine = options->engine_set ? options->engine : SIM_ENGINE_EVENTS,
+        .roster = hunters,
+        .hunter_count = hunter_count,
+        .ghost_count = options->ghosts,
+        .room_capacity = options->room_capacity,
+        .map = map,
+        .random_return = options->random_return,
+        .lanes = options->lanes
+    };
+    struct BatchStats stats;
+    double seconds = 0.0;
+    bool ok = runner_run(&config, &stats, &seconds);
+    free(hunters);
+    if (!ok) return 1;
+
+    estimate_print(&estimate, &stats);
+    printf("\nEstimated in %.1f ms, played %ld runs in %.3f s\n", estimate_ms, stats.runs, seconds);
     return 0;
 }
+
+static int run_interactive(struct House* house, const struct Options* options) {
+    struct Ghost* ghosts = calloc((size_t)options->ghosts, sizeof(*ghosts));
+    struct Hunter* hunters = calloc(DEFAULT_TEAM_SIZE, sizeof(*hunters));
+    if (!ghosts || !hunters) {
+        perror("Failed to allocate entities");
+        free(ghosts);
+        free(hunters);
+        return 1;
+    }
+
+    // Ghost init
+    uint64_t run_seed = sim_run_seed(options->seed, 0);
+    house_set_room_capacity(house, options->room_capacity);
+    house->random_return = options->random_return;
+    house->private_evidence = options->private_evidence;
+    house->reactive = options->reactive;
+    house->pool_workers = options->pool_workers;
+    sim_setup_ghosts(house, ghosts, options->ghosts, run_seed);
+
+    // Hunters input
+    int hunter_count = read_hunters_from_stdin(hunters, DEFAULT_TEAM_SIZE);
+
+    int status = 0;
+    if (hunter_count == 0) {
+        printf("No hunters provided. Exiting.\n");
+    } else {
+        for (int i = 0; i < hunter_count; i++) {
+            sim_setup_hunter(house, &hunters[i], run_seed);
+        }
+
+        struct SimResult result;
+        if (sim_run(options->engine, house, ghosts, options->ghosts, hunters, hunter_count, &result)) {
+            print_final_results(hunters, hunter_count, &result);
+        } else {
+            status = 1;
+        }
+    }
+
+    for (int i = 0; i < hunter_count; i++) {
+        stack_free(&hunters[i].breadcrumb);
+    }
+    free(ghosts);
+    free(hunters);
+    return status;
+}
+
+// Load or generate the house selected on the command line; NULL keeps Willow
+static bool prepare_map(const struct Options* options, struct HouseMap* storage, const struct HouseMap** map) {
+    *map = NULL;
+    if (options->map_path) {
+        if (!map_load(storage, options->map_path)) return false;
+        *map = storage;
+    } else if (options->generate_rooms) {
+        if (!map_generate(storage, (uint32_t)options->generate_rooms, options->map_seed)) {
+            fprintf(stderr, "Failed to generate a %d-room house\n", options->generate_rooms);
+            return false;
+        }
+        *map = storage;
+    }
+
+    if (options->save_map) {
+        const struct HouseMap* target = *map ? *map : map_willow();
+        size_t len = strlen(options->save_map);
+        bool text = len >= 4 && strcmp(options->save_map + len - 4, ".txt") == 0;
+        if (!target || !(text ? map_save_text(target, options->save_map) : map_save_binary(target, options->save_map))) {
+            return false;
+        }
+        printf("Saved %u-room house to %s\n", target->room_count, options->save_map);
+    }
+    return true;
+}
+
+// ---------- Main ----------
+int main(int argc, char** argv) {
+    struct Options options;
+    if (!parse_options(argc, argv, &options)) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    struct HouseMap map_storage;
+    const struct HouseMap* map = NULL;
+    memset(&map_storage, 0, sizeof(map_storage));
+    if (!prepare_map(&options, &map_storage, &map)) {
+        map_free(&map_storage);
+        return 1;
+    }
+    if (options.save_map && !options.batch && !options.bench && !options.estimate) {
+        map_free(&map_storage);
+        return 0;
+    }
+
+    // Batch runs print one summary; per-event output and CSV files are opt-in
+    if (options.batch || options.bench || options.estimate) {
+        log_set_console(false);
+        logger_set_enabled(options.csv_logs);
+    }
+    if (options.async_log && !logger_start_async(options.log_policy, (size_t)options.log_queue)) {
+        fprintf(stderr, "Failed to start async logger; falling back to buffered writes\n");
+    }
+
+    int status;
+    if (options.bench) {
+        status = bench_run(options.bench) ? 0 : 1;
+    } else if (options.estimate) {
+        status = run_estimate(&options, map);
+    } else if (options.batch) {
+        status = run_batch(&options, map);
+    } else {
+        struct House house;
+        if (house_init(&house, map)) {
+            status = run_interactive(&house, &options);
+            house_cleanup(&house);
+        } else {
+            perror("Failed to build the house");
+            status = 1;
+        }
+    }
+
+    logger_shutdown();
+    map_free(&map_storage);
+    return status;
+}
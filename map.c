@@ -0,0 +1,639 @@
+#include "map.h"
+#include "rng.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// ---- Builder ----
+// Rooms and doors are collected in declaration order and converted to the CSR
+// file image in one pass. Neighbour lists are sorted by room index, so the same
+// house gives the same adjacency (and the same games) however it was declared.
+struct MapBuilder {
+    uint32_t room_count;
+    size_t room_alloc;
+    uint32_t* name_offset;
+    uint8_t* is_exit;
+    char* names;
+    size_t names_size;
+    size_t names_alloc;
+    uint32_t* doors;          // (from, to) pairs of room indices, one per direction
+    size_t door_count;
+    size_t door_alloc;
+    int64_t start_room;       // -1 = first exit
+};
+
+static bool grow(void** array, size_t* alloc, size_t needed, size_t element_size) {
+    if (needed <= *alloc) return true;
+    size_t capacity = *alloc ? *alloc : 16;
+    while (capacity < needed) capacity *= 2;
+    void* grown = realloc(*array, capacity * element_size);
+    if (!grown) return false;
+    *array = grown;
+    *alloc = capacity;
+    return true;
+}
+
+static void builder_init(struct MapBuilder* b) {
+    memset(b, 0, sizeof(*b));
+    b->start_room = -1;
+}
+
+static void builder_free(struct MapBuilder* b) {
+    free(b->name_offset);
+    free(b->is_exit);
+    free(b->names);
+    free(b->doors);
+    builder_init(b);
+}
+
+static bool builder_add_room(struct MapBuilder* b, const char* name, size_t name_len, bool is_exit) {
+    if (b->room_count >= MAP_MAX_ROOMS) return false;
+    size_t rooms = (size_t)b->room_count + 1;
+    if (rooms > b->room_alloc) {
+        size_t exit_alloc = b->room_alloc;
+        if (!grow((void**)&b->name_offset, &b->room_alloc, rooms, sizeof(*b->name_offset))) return false;
+        if (!grow((void**)&b->is_exit, &exit_alloc, rooms, sizeof(*b->is_exit))) return false;
+    }
+    if (!grow((void**)&b->names, &b->names_alloc, b->names_size + name_len + 1, 1)) return false;
+    if (b->names_size + name_len + 1 > UINT32_MAX) return false;
+
+    memcpy(b->names + b->names_size, name, name_len);
+    b->names[b->names_size + name_len] = '\0';
+    b->name_offset[b->room_count] = (uint32_t)b->names_size;
+    b->is_exit[b->room_count] = is_exit ? 1 : 0;
+    b->names_size += name_len + 1;
+    b->room_count++;
+    return true;
+}
+
+static bool builder_add_passage(struct MapBuilder* b, uint32_t a, uint32_t c) {
+    if (a == c) return true; // a door back into the same room changes nothing
+    if (!grow((void**)&b->doors, &b->door_alloc, 2 * (b->door_count + 1), sizeof(*b->doors))) return false;
+    b->doors[2 * b->door_count] = a;
+    b->doors[2 * b->door_count + 1] = c;
+    b->door_count++;
+    return true;
+}
+
+static bool builder_add_door(struct MapBuilder* b, uint32_t a, uint32_t c) {
+    return builder_add_passage(b, a, c) && builder_add_passage(b, c, a);
+}
+
+static size_t align8(size_t value) {
+    return (value + 7) & ~(size_t)7;
+}
+
+static bool map_attach(struct HouseMap* map, void* image, size_t image_size, bool mapped, const char* source);
+
+// Convert the builder into a heap-allocated file image and attach the map to it
+static bool builder_finish(struct MapBuilder* b, struct HouseMap* map, const char* source) {
+    uint32_t n = b->room_count;
+    if (n == 0) {
+        fprintf(stderr, "%s: house has no rooms\n", source);
+        return false;
+    }
+    for (size_t d = 0; d < 2 * b->door_count; d++) {
+        if (b->doors[d] >= n) {
+            fprintf(stderr, "%s: door refers to room %u but only %u rooms exist\n", source, b->doors[d], n);
+            return false;
+        }
+    }
+    if (b->door_count > UINT32_MAX) {
+        fprintf(stderr, "%s: too many doors\n", source);
+        return false;
+    }
+
+    uint32_t start = 0;
+    if (b->start_room >= 0) {
+        if ((uint64_t)b->start_room >= n) {
+            fprintf(stderr, "%s: start room %lld does not exist\n", source, (long long)b->start_room);
+            return false;
+        }
+        start = (uint32_t)b->start_room;
+    } else {
+        for (uint32_t i = 0; i < n; i++) {
+            if (b->is_exit[i]) {
+                start = i;
+                break;
+            }
+        }
+    }
+
+    // Counting sort of the doors into per-room lists
+    uint32_t* offset = calloc((size_t)n + 1, sizeof(*offset));
+    uint32_t* adj = malloc((b->door_count + 1) * sizeof(*adj));
+    uint32_t* cursor = malloc((size_t)n * sizeof(*cursor));
+    if (!offset || !adj || !cursor) {
+        free(offset);
+        free(adj);
+        free(cursor);
+        return false;
+    }
+    for (size_t d = 0; d < b->door_count; d++) offset[b->doors[2 * d] + 1]++;
+    for (uint32_t i = 0; i < n; i++) offset[i + 1] += offset[i];
+    memcpy(cursor, offset, (size_t)n * sizeof(*cursor));
+    for (size_t d = 0; d < b->door_count; d++) {
+        uint32_t a = b->doors[2 * d];
+        adj[cursor[a]++] = b->doors[2 * d + 1];
+    }
+    free(cursor);
+
+    // Sort each room's neighbours (rooms have a handful of doors, so insertion
+    // sort) and drop repeated doors
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        uint32_t begin = offset[i];
+        uint32_t end = offset[i + 1];
+        offset[i] = kept;
+        for (uint32_t k = begin + 1; k < end; k++) {
+            uint32_t room = adj[k];
+            uint32_t j = k;
+            for (; j > begin && adj[j - 1] > room; j--) adj[j] = adj[j - 1];
+            adj[j] = room;
+        }
+        for (uint32_t k = begin; k < end; k++) {
+            if (kept > offset[i] && adj[kept - 1] == adj[k]) continue;
+            adj[kept++] = adj[k];
+        }
+    }
+    offset[n] = kept;
+
+    struct MapFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC));
+    header.version = MAP_VERSION;
+    header.room_count = n;
+    header.adj_count = kept;
+    header.start_room = start;
+    header.index_bits = n <= MAP_INDEX16_LIMIT ? 16 : 32;
+    header.names_size = (uint32_t)b->names_size;
+    header.adj_offset_at = align8(sizeof(header));
+    header.adj_at = align8(header.adj_offset_at + ((size_t)n + 1) * sizeof(uint32_t));
+    header.is_exit_at = align8(header.adj_at + (size_t)kept * (header.index_bits / 8));
+    header.name_offset_at = align8(header.is_exit_at + n);
+    header.names_at = align8(header.name_offset_at + (size_t)n * sizeof(uint32_t));
+    size_t image_size = header.names_at + b->names_size;
+
+    unsigned char* image = calloc(1, image_size);
+    if (!image) {
+        free(offset);
+        free(adj);
+        return false;
+    }
+    memcpy(image, &header, sizeof(header));
+    memcpy(image + header.adj_offset_at, offset, ((size_t)n + 1) * sizeof(uint32_t));
+    if (header.index_bits == 16) {
+        uint16_t* adj16 = (uint16_t*)(image + header.adj_at);
+        for (uint32_t k = 0; k < kept; k++) adj16[k] = (uint16_t)adj[k];
+    } else {
+        memcpy(image + header.adj_at, adj, (size_t)kept * sizeof(uint32_t));
+    }
+    memcpy(image + header.is_exit_at, b->is_exit, n);
+    memcpy(image + header.name_offset_at, b->name_offset, (size_t)n * sizeof(uint32_t));
+    memcpy(image + header.names_at, b->names, b->names_size);
+    free(offset);
+    free(adj);
+
+    if (!map_attach(map, image, image_size, false, source)) {
+        free(image);
+        return false;
+    }
+    return true;
+}
+
+// ---- File image ----
+
+// Multi-source BFS from every exit. Neighbours are visited in adjacency order,
+// so ties between equally short routes always resolve the same way.
+static bool map_build_routes(struct HouseMap* map) {
+    uint32_t n = map->room_count;
+    uint32_t* routes = malloc(3 * (size_t)n * sizeof(*routes));
+    if (!routes) return false;
+    uint32_t* dist = routes;
+    uint32_t* hop = routes + n;
+    uint32_t* queue = routes + 2 * (size_t)n;
+
+    uint32_t head = 0;
+    uint32_t tail = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        hop[i] = MAP_NO_ROUTE;
+        dist[i] = MAP_NO_ROUTE;
+        if (map->is_exit[i]) {
+            dist[i] = 0;
+            queue[tail++] = i;
+        }
+    }
+    while (head < tail) {
+        uint32_t room = queue[head++];
+        for (uint32_t k = map->adj_offset[room]; k < map->adj_offset[room + 1]; k++) {
+            uint32_t next = map_adj(map, k);
+            if (dist[next] != MAP_NO_ROUTE) continue;
+            dist[next] = dist[room] + 1;
+            hop[next] = room;
+            queue[tail++] = next;
+        }
+    }
+
+    map->exit_dist = dist;
+    map->exit_hop = hop;
+    map->routes = routes;
+    return true;
+}
+
+// Point the map's arrays into a file image after checking every offset and index,
+// so a truncated or hostile file cannot send the simulation out of bounds
+static bool map_attach(struct HouseMap* map, void* image, size_t image_size, bool mapped, const char* source) {
+    struct MapFileHeader header;
+    if (image_size < sizeof(header)) {
+        fprintf(stderr, "%s: file too short for a map header\n", source);
+        return false;
+    }
+    memcpy(&header, image, sizeof(header));
+    if (memcmp(header.magic, MAP_MAGIC, sizeof(MAP_MAGIC)) != 0 || header.version != MAP_VERSION) {
+        fprintf(stderr, "%s: not a version %d house map\n", source, MAP_VERSION);
+        return false;
+    }
+
+    uint64_t n = header.room_count;
+    uint64_t width = header.index_bits / 8;
+    bool valid = n > 0 && n <= MAP_MAX_ROOMS && header.start_room < n
+        && header.index_bits == (n <= MAP_INDEX16_LIMIT ? 16u : 32u)
+        && header.adj_offset_at % 8 == 0 && header.adj_at % 8 == 0 && header.name_offset_at % 8 == 0
+        && header.adj_offset_at <= image_size && (n + 1) * 4 <= image_size - header.adj_offset_at
+        && header.adj_at <= image_size && header.adj_count * width <= image_size - header.adj_at
+        && header.is_exit_at <= image_size && n <= image_size - header.is_exit_at
+        && header.name_offset_at <= image_size && n * 4 <= image_size - header.name_offset_at
+        && header.names_at <= image_size && header.names_size <= image_size - header.names_at
+        && header.names_size > 0;
+    if (!valid) {
+        fprintf(stderr, "%s: corrupt map header\n", source);
+        return false;
+    }
+
+    const unsigned char* bytes = image;
+    const uint32_t* adj_offset = (const uint32_t*)(bytes + header.adj_offset_at);
+    const uint32_t* name_offset = (const uint32_t*)(bytes + header.name_offset_at);
+    const char* names = (const char*)(bytes + header.names_at);
+    const uint16_t* adj16 = width == 2 ? (const uint16_t*)(bytes + header.adj_at) : NULL;
+    const uint32_t* adj32 = width == 4 ? (const uint32_t*)(bytes + header.adj_at) : NULL;
+
+    if (adj_offset[0] != 0 || adj_offset[n] != header.adj_count || names[header.names_size - 1] != '\0') {
+        fprintf(stderr, "%s: corrupt map arrays\n", source);
+        return false;
+    }
+    for (uint64_t i = 0; i < n; i++) {
+        if (adj_offset[i] > adj_offset[i + 1] || name_offset[i] >= header.names_size) {
+            fprintf(stderr, "%s: corrupt entry for room %llu\n", source, (unsigned long long)i);
+            return false;
+        }
+    }
+    for (uint32_t k = 0; k < header.adj_count; k++) {
+        uint32_t room = adj16 ? adj16[k] : adj32[k];
+        if (room >= n) {
+            fprintf(stderr, "%s: door to room %u out of range\n", source, room);
+            return false;
+        }
+    }
+    // Neighbour order decides where a random step goes, so every loader must
+    // agree on it: lists are strictly increasing, as builder_finish writes them
+    for (uint64_t i = 0; i < n; i++) {
+        for (uint32_t k = adj_offset[i] + 1; k < adj_offset[i + 1]; k++) {
+            uint32_t before = adj16 ? adj16[k - 1] : adj32[k - 1];
+            uint32_t room = adj16 ? adj16[k] : adj32[k];
+            if (room <= before) {
+                fprintf(stderr, "%s: doors of room %llu not in canonical order\n", source, (unsigned long long)i);
+                return false;
+            }
+        }
+    }
+
+    map->room_count = header.room_count;
+    map->adj_count = header.adj_count;
+    map->start_room = header.start_room;
+    map->adj_offset = adj_offset;
+    map->adj16 = adj16;
+    map->adj32 = adj32;
+    map->is_exit = bytes + header.is_exit_at;
+    map->name_offset = name_offset;
+    map->names = names;
+    map->image = image;
+    map->image_size = image_size;
+    map->mapped = mapped;
+    if (!map_build_routes(map)) {
+        // The caller releases the image, so the map must not point into it
+        fprintf(stderr, "%s: out of memory building exit routes\n", source);
+        memset(map, 0, sizeof(*map));
+        return false;
+    }
+    return true;
+}
+
+static bool map_load_binary(struct HouseMap* map, const char* path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        perror(path);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        fprintf(stderr, "%s: cannot read map size\n", path);
+        close(fd);
+        return false;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void* image = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (image == MAP_FAILED) {
+        perror(path);
+        return false;
+    }
+    if (!map_attach(map, image, size, true, path)) {
+        munmap(image, size);
+        return false;
+    }
+    return true;
+}
+
+// ---- Text format ----
+static char* skip_blanks(char* text) {
+    while (*text == ' ' || *text == '\t') text++;
+    return text;
+}
+
+static bool parse_index(char** cursor, uint32_t* out) {
+    char* text = skip_blanks(*cursor);
+    char* end = NULL;
+    errno = 0;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == text || errno != 0 || value >= MAP_MAX_ROOMS) return false;
+    *out = (uint32_t)value;
+    *cursor = end;
+    return true;
+}
+
+static bool map_load_text(struct HouseMap* map, const char* path) {
+    FILE* file = fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    struct MapBuilder b;
+    builder_init(&b);
+    char* line = NULL;
+    size_t line_alloc = 0;
+    int line_no = 0;
+    bool ok = true;
+    while (ok && getline(&line, &line_alloc, file) >= 0) {
+        line_no++;
+        char* hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+        line[strcspn(line, "\r\n")] = '\0';
+        char* cursor = skip_blanks(line);
+        if (*cursor == '\0') continue;
+
+        if (strncmp(cursor, "room", 4) == 0 && (cursor[4] == ' ' || cursor[4] == '\t')) {
+            cursor = skip_blanks(cursor + 4);
+            bool is_exit;
+            if (strncmp(cursor, "exit", 4) == 0) {
+                is_exit = true;
+                cursor += 4;
+            } else if (*cursor == '-') {
+                is_exit = false;
+                cursor += 1;
+            } else {
+                fprintf(stderr, "%s:%d: expected 'room <exit|-> <name>'\n", path, line_no);
+                ok = false;
+                break;
+            }
+            char* name = skip_blanks(cursor);
+            size_t name_len = strlen(name);
+            while (name_len > 0 && (name[name_len - 1] == ' ' || name[name_len - 1] == '\t')) name_len--;
+            if (name == cursor || name_len == 0) {
+                fprintf(stderr, "%s:%d: room needs a name\n", path, line_no);
+                ok = false;
+            } else {
+                ok = builder_add_room(&b, name, name_len, is_exit);
+            }
+        } else if (strncmp(cursor, "door", 4) == 0 && (cursor[4] == ' ' || cursor[4] == '\t')) {
+            cursor += 4;
+            uint32_t a, c;
+            if (!parse_index(&cursor, &a) || !parse_index(&cursor, &c) || *skip_blanks(cursor) != '\0') {
+                fprintf(stderr, "%s:%d: expected 'door <a> <b>'\n", path, line_no);
+                ok = false;
+            } else {
+                ok = builder_add_door(&b, a, c);
+            }
+        } else if (strncmp(cursor, "passage", 7) == 0 && (cursor[7] == ' ' || cursor[7] == '\t')) {
+            cursor += 7;
+            uint32_t a, c;
+            if (!parse_index(&cursor, &a) || !parse_index(&cursor, &c) || *skip_blanks(cursor) != '\0') {
+                fprintf(stderr, "%s:%d: expected 'passage <a> <b>'\n", path, line_no);
+                ok = false;
+            } else {
+                ok = builder_add_passage(&b, a, c);
+            }
+        } else if (strncmp(cursor, "start", 5) == 0 && (cursor[5] == ' ' || cursor[5] == '\t')) {
+            cursor += 5;
+            uint32_t start;
+            if (!parse_index(&cursor, &start) || *skip_blanks(cursor) != '\0') {
+                fprintf(stderr, "%s:%d: expected 'start <index>'\n", path, line_no);
+                ok = false;
+            } else {
+                b.start_room = start;
+            }
+        } else {
+            fprintf(stderr, "%s:%d: unknown directive '%s'\n", path, line_no, cursor);
+            ok = false;
+        }
+    }
+    free(line);
+    fclose(file);
+
+    if (ok) ok = builder_finish(&b, map, path);
+    builder_free(&b);
+    return ok;
+}
+
+bool map_load(struct HouseMap* map, const char* path) {
+    memset(map, 0, sizeof(*map));
+
+    char magic[sizeof(MAP_MAGIC)] = { 0 };
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    size_t got = fread(magic, 1, sizeof(magic), file);
+    fclose(file);
+
+    if (got == sizeof(magic) && memcmp(magic, MAP_MAGIC, sizeof(MAP_MAGIC)) == 0) {
+        return map_load_binary(map, path);
+    }
+    return map_load_text(map, path);
+}
+
+bool map_save_binary(const struct HouseMap* map, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+    bool ok = fwrite(map->image, 1, map->image_size, file) == map->image_size;
+    if (fclose(file) != 0) ok = false;
+    if (!ok) fprintf(stderr, "%s: write failed\n", path);
+    return ok;
+}
+
+// Whether room a has a door into room b; neighbour lists are sorted
+static bool map_has_door(const struct HouseMap* map, uint32_t a, uint32_t b) {
+    uint32_t low = map->adj_offset[a];
+    uint32_t high = map->adj_offset[a + 1];
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        uint32_t room = map_adj(map, mid);
+        if (room == b) return true;
+        if (room < b) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+bool map_save_text(const struct HouseMap* map, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (!file) {
+        perror(path);
+        return false;
+    }
+
+    fprintf(file, "# %u rooms\n", map->room_count);
+    for (uint32_t i = 0; i < map->room_count; i++) {
+        fprintf(file, "room %s %s\n", map->is_exit[i] ? "exit" : "-", map_room_name(map, i));
+    }
+    // A two-way door is stored once per direction; write it from its lower room.
+    // Entries with no way back are one-way passages. Neighbour lists are sorted,
+    // so loading the file rebuilds the same adjacency.
+    for (uint32_t i = 0; i < map->room_count; i++) {
+        for (uint32_t k = map->adj_offset[i]; k < map->adj_offset[i + 1]; k++) {
+            uint32_t other = map_adj(map, k);
+            if (!map_has_door(map, other, i)) {
+                fprintf(file, "passage %u %u\n", i, other);
+            } else if (i < other) {
+                fprintf(file, "door %u %u\n", i, other);
+            }
+        }
+    }
+    fprintf(file, "start %u\n", map->start_room);
+
+    bool ok = !ferror(file);
+    if (fclose(file) != 0) ok = false;
+    if (!ok) fprintf(stderr, "%s: write failed\n", path);
+    return ok;
+}
+
+void map_free(struct HouseMap* map) {
+    free(map->routes);
+    if (map->image) {
+        if (map->mapped) {
+            munmap(map->image, map->image_size);
+        } else {
+            free(map->image);
+        }
+    }
+    memset(map, 0, sizeof(*map));
+}
+
+// ---- Generator ----
+bool map_generate(struct HouseMap* map, uint32_t room_count, uint64_t seed) {
+    memset(map, 0, sizeof(*map));
+    if (room_count < 2 || room_count > MAP_MAX_ROOMS) return false;
+
+    struct Rng rng;
+    rng_seed(&rng, seed, RNG_STREAM_MAP);
+
+    uint32_t width = 1;
+    while ((uint64_t)width * width < room_count) width++;
+
+    struct MapBuilder b;
+    builder_init(&b);
+    bool ok = builder_add_room(&b, "Van", 3, true);
+    char name[32];
+    for (uint32_t i = 1; ok && i < room_count; i++) {
+        int len = snprintf(name, sizeof(name), "Room %u", i);
+        ok = builder_add_room(&b, name, (size_t)len, false);
+    }
+
+    // Rooms sit on a width x width grid with the van in the corner. Every room
+    // opens onto its north or west neighbour (a binary-tree maze, so the house is
+    // connected), and one in eight also gets the other door to form loops.
+    for (uint32_t i = 1; ok && i < room_count; i++) {
+        bool has_north = i >= width;
+        bool has_west = i % width != 0;
+        bool north = has_north && (!has_west || rng_below(&rng, 2) == 0);
+        ok = builder_add_door(&b, i, north ? i - width : i - 1);
+        if (ok && has_north && has_west && rng_below(&rng, 8) == 0) {
+            ok = builder_add_door(&b, i, north ? i - 1 : i - width);
+        }
+    }
+    b.start_room = 0;
+
+    if (ok) ok = builder_finish(&b, map, "generated map");
+    builder_free(&b);
+    return ok;
+}
+
+// ---- Willow ----
+static struct HouseMap willow_map;
+static bool willow_ready = false;
+static pthread_once_t willow_once = PTHREAD_ONCE_INIT;
+
+static void build_willow(void) {
+    // Willow House layout from Phasmaphobia, DO NOT MODIFY HOUSE LAYOUT
+    static const char* const rooms[] = {
+        "Van", "Hallway", "Master Bedroom", "Boy's Bedroom", "Bathroom", "Basement",
+        "Basement Hallway", "Right Storage Room", "Left Storage Room", "Kitchen",
+        "Living Room", "Garage", "Utility Room"
+    };
+    static const uint32_t doors[][2] = {
+        { 0, 1 },    // Van - Hallway
+        { 1, 2 },    // Hallway - Master Bedroom
+        { 1, 3 },    // Hallway - Boy's Bedroom
+        { 1, 4 },    // Hallway - Bathroom
+        { 1, 9 },    // Hallway - Kitchen
+        { 1, 5 },    // Hallway - Basement
+        { 5, 6 },    // Basement - Basement Hallway
+        { 6, 7 },    // Basement Hallway - Right Storage Room
+        { 6, 8 },    // Basement Hallway - Left Storage Room
+        { 9, 10 },   // Kitchen - Living Room
+        { 9, 11 },   // Kitchen - Garage
+        { 11, 12 },  // Garage - Utility Room
+    };
+
+    struct MapBuilder b;
+    builder_init(&b);
+    bool ok = true;
+    for (size_t i = 0; ok && i < sizeof(rooms) / sizeof(rooms[0]); i++) {
+        ok = builder_add_room(&b, rooms[i], strlen(rooms[i]), i == 0); // Van is the exit
+    }
+    for (size_t i = 0; ok && i < sizeof(doors) / sizeof(doors[0]); i++) {
+        ok = builder_add_door(&b, doors[i][0], doors[i][1]);
+    }
+    b.start_room = 0;
+    willow_ready = ok && builder_finish(&b, &willow_map, "willow");
+    builder_free(&b);
+}
+
+const struct HouseMap* map_willow(void) {
+    pthread_once(&willow_once, build_willow);
+    return willow_ready ? &willow_map : NULL;
+}
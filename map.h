@@ -0,0 +1,138 @@
+#ifndef MAP_H
+#define MAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// House layouts. A map is the read-only part of a house: room names, exits and
+// the doors between rooms, stored as compressed-sparse-row (CSR) arrays of room
+// indices. Every worker's House points at one shared map and only keeps the
+// per-game room state (evidence, occupants, locks) itself.
+//
+// Text format, for authoring. One directive per line, '#' starts a comment:
+//   room <exit|-> <name...>   rooms are numbered 0, 1, 2 ... in file order
+//   door <a> <b>              two-way door between rooms a and b
+//   passage <a> <b>           one-way door from room a into room b
+//   start <index>             room the hunters start in (default: first exit)
+//
+// Binary format: a MapFileHeader followed by the CSR arrays at 8-byte aligned
+// offsets, in native byte order. The file is mmapped and used in place, so
+// loading costs one validation pass over the arrays. Each room's neighbours
+// are sorted by index in both formats: random moves pick a neighbour by
+// position, so this is what makes a house play the same games however it
+// was written.
+//
+// Every load also runs a breadth-first search from all exits, giving each room
+// its distance to the nearest exit and the neighbour one step closer to it.
+
+#define MAP_INDEX16_LIMIT 65536      // houses up to this many rooms use 16-bit indices
+#define MAP_MAX_ROOMS 0x7FFFFFFF     // room indices must fit an int
+#define MAP_MAGIC "GBHOUSE"
+#define MAP_VERSION 2                // 2: neighbour lists sorted
+#define MAP_NO_ROUTE UINT32_MAX      // exit_hop/exit_dist of exits and cut-off rooms
+
+struct MapFileHeader {
+    char magic[8];                // MAP_MAGIC, NUL padded
+    uint32_t version;             // MAP_VERSION
+    uint32_t room_count;
+    uint32_t adj_count;           // adjacency entries, two per door and one per passage
+    uint32_t start_room;
+    uint32_t index_bits;          // 16 or 32
+    uint32_t names_size;          // bytes of NUL-terminated names
+    uint64_t adj_offset_at;       // byte offsets of each array from the file start
+    uint64_t adj_at;
+    uint64_t is_exit_at;
+    uint64_t name_offset_at;
+    uint64_t names_at;
+};
+
+struct HouseMap {
+    uint32_t room_count;
+    uint32_t adj_count;
+    uint32_t start_room;
+    const uint32_t* adj_offset;   // room_count + 1 entries; room i's neighbours are
+                                  // entries adj_offset[i] .. adj_offset[i + 1] - 1
+    const uint16_t* adj16;        // neighbour indices when room_count <= MAP_INDEX16_LIMIT
+    const uint32_t* adj32;        // neighbour indices otherwise
+    const uint8_t* is_exit;
+    const uint32_t* name_offset;  // room i's name is names + name_offset[i]
+    const char* names;
+    const uint32_t* exit_dist;    // doors to the nearest exit, MAP_NO_ROUTE if none reachable
+    const uint32_t* exit_hop;     // neighbour on a shortest path to an exit; MAP_NO_ROUTE
+                                  // in exit rooms and rooms with no path out
+    void* routes;                 // heap block backing exit_dist and exit_hop
+    void* image;                  // file image backing the layout arrays
+    size_t image_size;
+    bool mapped;                  // image is an mmap rather than a heap block
+};
+
+/**
+ * @brief Room index stored in adjacency entry k.
+ * @param[in] map Loaded map.
+ * @param[in] k Entry in [0, adj_count).
+ * @return Neighbour room index.
+ */
+static inline uint32_t map_adj(const struct HouseMap* map, uint32_t k) {
+    return map->adj16 ? map->adj16[k] : map->adj32[k];
+}
+
+/**
+ * @brief Name of one room.
+ * @param[in] map Loaded map.
+ * @param[in] room Room index.
+ * @return NUL-terminated name owned by the map.
+ */
+static inline const char* map_room_name(const struct HouseMap* map, uint32_t room) {
+    return map->names + map->name_offset[room];
+}
+
+/**
+ * @brief The built-in Willow layout, built once and shared by every caller.
+ * @return Map that stays valid until exit; NULL when out of memory.
+ */
+const struct HouseMap* map_willow(void);
+
+/**
+ * @brief Load a map file, detecting the binary format by its magic and
+ *        otherwise parsing the text format.
+ * @param[out] map Map to fill; release it with map_free.
+ * @param[in] path File to read.
+ * @return false (with a message on stderr) when the file is unreadable or invalid.
+ */
+bool map_load(struct HouseMap* map, const char* path);
+
+/**
+ * @brief Generate a house of room_count rooms on a square grid: a random
+ *        spanning tree of doors so every room is reachable, plus extra doors
+ *        that create loops. Room 0 is the van and the only exit.
+ * @param[out] map Map to fill; release it with map_free.
+ * @param[in] room_count Rooms to create, at least 2.
+ * @param[in] seed Layout seed; equal seeds give equal maps.
+ * @return false when out of memory or room_count is out of range.
+ */
+bool map_generate(struct HouseMap* map, uint32_t room_count, uint64_t seed);
+
+/**
+ * @brief Write a map in the binary format.
+ * @param[in] map Map to save.
+ * @param[in] path Destination file.
+ * @return false when the file could not be written.
+ */
+bool map_save_binary(const struct HouseMap* map, const char* path);
+
+/**
+ * @brief Write a map in the text format.
+ * @param[in] map Map to save.
+ * @param[in] path Destination file.
+ * @return false when the file could not be written.
+ */
+bool map_save_text(const struct HouseMap* map, const char* path);
+
+/**
+ * @brief Release a map filled by map_load or map_generate. Safe on a zeroed map.
+ * @param[in,out] map Map to release.
+ */
+void map_free(struct HouseMap* map);
+
+#endif // MAP_H
@@ -0,0 +1,296 @@
+#include "pool.h"
+#include "helpers.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#define POOL_IDLE_MAX_NS 5000000LL   // longest idle sleep between queue scans
+
+enum PoolEntity { POOL_GHOST = 0, POOL_HUNTER = 1 };
+
+// One entity's place in a run queue; order breaks ties in scheduling order
+struct PoolTask {
+    long long due_ns;          // CLOCK_MONOTONIC deadline of the next tick
+    unsigned long order;
+    enum PoolEntity kind;
+    int index;
+};
+
+// Binary min-heap keyed by (due_ns, order), one per worker. Any task can end
+// up in any queue after steals, so every queue reserves room for all tasks;
+// the reservation is virtual memory until a queue actually grows into it.
+struct RunQueue {
+    pthread_mutex_t lock;
+    struct PoolTask* items;
+    int count;
+    unsigned long next_order;
+};
+
+struct Pool {
+    struct House* house;
+    struct Ghost* ghosts;
+    struct Hunter* hunters;
+    struct RunQueue* queues;
+    int worker_count;
+    atomic_int active_hunters;
+    atomic_bool running;       // cleared when the last hunter exits
+    atomic_long ticks;
+    atomic_long steals;
+    long long end_ns;          // when the last hunter exited, written once
+};
+
+struct PoolWorker {
+    struct Pool* pool;
+    int index;
+    pthread_t thread;
+};
+
+static long long pool_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long long timespec_ns(const struct timespec* ts) {
+    return (long long)ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+// Zeroed memory from the game's arena, or from the heap without one
+static void* pool_alloc(struct Arena* arena, size_t bytes) {
+    if (!arena) return calloc(1, bytes);
+    void* memory = arena_alloc(arena, bytes, _Alignof(max_align_t));
+    if (memory) memset(memory, 0, bytes);
+    return memory;
+}
+
+// ---- Run queues (caller holds queue->lock) ----
+static bool task_before(const struct PoolTask* a, const struct PoolTask* b) {
+    if (a->due_ns != b->due_ns) return a->due_ns < b->due_ns;
+    return a->order < b->order;
+}
+
+static void queue_push(struct RunQueue* queue, long long due_ns, enum PoolEntity kind, int index) {
+    int child = queue->count++;
+    struct PoolTask task = { due_ns, queue->next_order++, kind, index };
+
+    while (child > 0) {
+        int parent = (child - 1) / 2;
+        if (!task_before(&task, &queue->items[parent])) break;
+        queue->items[child] = queue->items[parent];
+        child = parent;
+    }
+    queue->items[child] = task;
+}
+
+static void queue_pop(struct RunQueue* queue, struct PoolTask* out) {
+    *out = queue->items[0];
+
+    struct PoolTask last = queue->items[--queue->count];
+    int parent = 0;
+    for (;;) {
+        int child = parent * 2 + 1;
+        if (child >= queue->count) break;
+        if (child + 1 < queue->count && task_before(&queue->items[child + 1], &queue->items[child])) {
+            child++;
+        }
+        if (!task_before(&queue->items[child], &last)) break;
+        queue->items[parent] = queue->items[child];
+        parent = child;
+    }
+    if (queue->count > 0) queue->items[parent] = last;
+}
+
+// Pop the earliest task of a queue if it is due by now_ns
+static bool queue_take_due(struct RunQueue* queue, long long now_ns, struct PoolTask* out) {
+    pthread_mutex_lock(&queue->lock);
+    bool due = queue->count > 0 && queue->items[0].due_ns <= now_ns;
+    if (due) queue_pop(queue, out);
+    pthread_mutex_unlock(&queue->lock);
+    return due;
+}
+
+// ---- Workers ----
+// Take a due task from another worker, starting with the next one along so
+// thieves spread out over their victims
+static bool pool_steal(struct Pool* pool, int self, long long now_ns, struct PoolTask* out) {
+    for (int k = 1; k < pool->worker_count; k++) {
+        int victim = (self + k) % pool->worker_count;
+        if (queue_take_due(&pool->queues[victim], now_ns, out)) {
+            atomic_fetch_add_explicit(&pool->steals, 1, memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Earliest deadline in any queue, or a ghost tick away when all are empty
+static long long pool_next_due(struct Pool* pool, long long now_ns) {
+    long long next = now_ns + GHOST_TICK_MS * 1000000LL;
+    for (int w = 0; w < pool->worker_count; w++) {
+        struct RunQueue* queue = &pool->queues[w];
+        pthread_mutex_lock(&queue->lock);
+        if (queue->count > 0 && queue->items[0].due_ns < next) next = queue->items[0].due_ns;
+        pthread_mutex_unlock(&queue->lock);
+    }
+    return next;
+}
+
+// Tick one entity; returns its next deadline, or -1 once it has left
+static long long pool_tick(struct Pool* pool, const struct PoolTask* task) {
+    struct TickSchedule* schedule;
+    if (task->kind == POOL_GHOST) {
+        struct Ghost* ghost = &pool->ghosts[task->index];
+        if (!ghost_tick(ghost)) return -1;
+        schedule = &ghost->schedule;
+    } else {
+        struct Hunter* hunter = &pool->hunters[task->index];
+        if (!hunter_tick(hunter)) {
+            if (atomic_fetch_sub(&pool->active_hunters, 1) == 1) {
+                // Last hunter out: the game is over, ghosts are simply not resumed
+                pool->end_ns = pool_now_ns();
+                atomic_store(&pool->running, false);
+                house_wake_all(pool->house);
+            }
+            return -1;
+        }
+        schedule = &hunter->schedule;
+    }
+
+    struct timespec deadline;
+    simclock_schedule_next(schedule, &deadline);
+    return timespec_ns(&deadline);
+}
+
+static void* pool_worker_fn(void* arg) {
+    struct PoolWorker* worker = arg;
+    struct Pool* pool = worker->pool;
+    struct RunQueue* own = &pool->queues[worker->index];
+    long ticks = 0;
+    logger_set_run(pool->house->log_run);
+
+    while (atomic_load(&pool->running)) {
+        long long now_ns = pool_now_ns();
+        struct PoolTask task;
+        if (!queue_take_due(own, now_ns, &task) && !pool_steal(pool, worker->index, now_ns, &task)) {
+            // Nothing due anywhere: sleep until the earliest deadline, briefly
+            // enough to catch a task a busy worker queues meanwhile
+            long long wake_ns = pool_next_due(pool, now_ns);
+            if (wake_ns > now_ns + POOL_IDLE_MAX_NS) wake_ns = now_ns + POOL_IDLE_MAX_NS;
+            struct timespec wake = { (time_t)(wake_ns / 1000000000LL), (long)(wake_ns % 1000000000LL) };
+            simclock_sleep_until(&pool->house->waker, &wake, &pool->running);
+            continue;
+        }
+
+        ticks++;
+        long long due_ns = pool_tick(pool, &task);
+        if (due_ns >= 0) {
+            pthread_mutex_lock(&own->lock);
+            queue_push(own, due_ns, task.kind, task.index);
+            pthread_mutex_unlock(&own->lock);
+        }
+    }
+
+    atomic_fetch_add_explicit(&pool->ticks, ticks, memory_order_relaxed);
+    return NULL;
+}
+
+// ---- Game ----
+bool pool_run(struct House* house, struct Ghost* ghosts, int ghost_count, struct Hunter* hunters, int hunter_count,
+              int workers, struct PoolReport* report) {
+    if (workers <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        workers = cores > 0 ? (int)cores : 1;
+    }
+    int task_count = ghost_count + hunter_count;
+
+    struct Pool pool = {
+        .house = house,
+        .ghosts = ghosts,
+        .hunters = hunters,
+        .worker_count = workers,
+        .end_ns = 0
+    };
+    atomic_init(&pool.active_hunters, hunter_count);
+    atomic_init(&pool.running, hunter_count > 0);
+    atomic_init(&pool.ticks, 0);
+    atomic_init(&pool.steals, 0);
+
+    // Queues and workers live in the game's arena when the house has one
+    struct Arena* arena = house->arena;
+    pool.queues = pool_alloc(arena, (size_t)workers * sizeof(*pool.queues));
+    struct PoolWorker* pool_workers = pool_alloc(arena, (size_t)workers * sizeof(*pool_workers));
+    bool ok = pool.queues && pool_workers;
+    int queues_ready = 0;
+    for (int w = 0; ok && w < workers; w++) {
+        size_t bytes = (size_t)task_count * sizeof(*pool.queues[w].items);
+        pool.queues[w].items = arena ? arena_alloc(arena, bytes, _Alignof(struct PoolTask)) : malloc(bytes);
+        ok = pool.queues[w].items != NULL;
+        if (ok) {
+            pthread_mutex_init(&pool.queues[w].lock, NULL);
+            queues_ready++;
+        }
+    }
+
+    long long start_ns = pool_now_ns();
+    if (ok) {
+        // Same start order as the other engines: ghosts first, then every
+        // hunter, dealt round-robin over the workers and all due at once
+        int next_queue = 0;
+        for (int i = 0; i < ghost_count; i++) {
+            ghost_start(&ghosts[i]);
+            simclock_schedule_start(&ghosts[i].schedule, GHOST_TICK_MS);
+            queue_push(&pool.queues[next_queue], start_ns, POOL_GHOST, i);
+            next_queue = (next_queue + 1) % workers;
+        }
+        for (int i = 0; i < hunter_count; i++) {
+            hunter_start(&hunters[i]);
+            simclock_schedule_start(&hunters[i].schedule, HUNTER_TICK_MS);
+            queue_push(&pool.queues[next_queue], start_ns, POOL_HUNTER, i);
+            next_queue = (next_queue + 1) % workers;
+        }
+    } else {
+        fprintf(stderr, "Failed to allocate the pool run queues\n");
+    }
+
+    int started = 0;
+    for (int w = 0; ok && w < workers; w++) {
+        pool_workers[w].pool = &pool;
+        pool_workers[w].index = w;
+        if (pthread_create(&pool_workers[w].thread, NULL, pool_worker_fn, &pool_workers[w]) != 0) {
+            perror("Failed to create pool worker");
+            break;
+        }
+        started++;
+    }
+    if (ok && started == 0) {
+        // Nobody can run the tasks; the hunters are in their rooms and stay there
+        ok = false;
+    }
+    for (int w = 0; w < started; w++) {
+        pthread_join(pool_workers[w].thread, NULL);
+    }
+    for (int i = 0; i < ghost_count; i++) {
+        atomic_store(&ghosts[i].running, false);
+    }
+
+    for (int w = 0; w < queues_ready; w++) {
+        pthread_mutex_destroy(&pool.queues[w].lock);
+        if (!arena) free(pool.queues[w].items);
+    }
+    if (!arena) {
+        free(pool.queues);
+        free(pool_workers);
+    }
+
+    if (report) {
+        report->duration_ms = ok ? (pool.end_ns - start_ns) / 1000000LL : 0;
+        report->ticks = atomic_load(&pool.ticks);
+        report->steals = atomic_load(&pool.steals);
+        report->workers = started;
+    }
+    return ok;
+}
@@ -0,0 +1,39 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include "defs.h"
+
+// Real-time games without a thread per entity. Each hunter and ghost is a task
+// whose tick function is already a resumable state machine, so a task needs no
+// stack of its own: a few bytes of scheduling state plus the entity itself.
+// Tasks are multiplexed over a small pool of worker threads. Every worker owns
+// a run queue ordered by the tasks' absolute tick deadlines; a worker with
+// nothing due takes a due task from another worker's queue, and the task then
+// stays with the thief.
+
+// What a pooled game did, besides its outcome
+struct PoolReport {
+    long long duration_ms;     // wall time from start until the last hunter exits
+    long ticks;                // entity ticks executed
+    long steals;               // tasks taken from another worker's queue
+    int workers;               // worker threads used
+};
+
+/**
+ * @brief Run one game in real time on a pool of worker threads. Entities tick
+ *        on the same absolute deadlines as the threads engine (their
+ *        TickSchedule records overruns when the pool falls behind) and run
+ *        the same tick logic; a worker sleeps only when no task anywhere is due.
+ * @param[in,out] house House the game runs in; its waker wakes idle workers.
+ * @param[in,out] ghosts Ghosts prepared for a new game.
+ * @param[in] ghost_count Number of ghosts.
+ * @param[in,out] hunters Hunters prepared for a new game.
+ * @param[in] hunter_count Number of hunters.
+ * @param[in] workers Worker threads, 0 = one per online core.
+ * @param[out] report Duration, ticks and steals.
+ * @return false when the run queues or worker threads could not be created.
+ */
+bool pool_run(struct House* house, struct Ghost* ghosts, int ghost_count, struct Hunter* hunters, int hunter_count,
+              int workers, struct PoolReport* report);
+
+#endif // POOL_H
@@ -0,0 +1,17 @@
+#include "rng.h"
+
+uint64_t rng_mix(uint64_t a, uint64_t b) {
+    uint64_t z = a + 0x9E3779B97F4A7C15ULL * (b + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void rng_seed(struct Rng* rng, uint64_t seed, uint64_t stream) {
+    // Standard PCG32 seeding: the stream picks the increment, the seed the start state
+    rng->state = 0;
+    rng->inc = (rng_mix(stream, 0x5851F42D4C957F2DULL) << 1u) | 1u;
+    rng_next(rng);
+    rng->state += rng_mix(seed, stream);
+    rng_next(rng);
+}
@@ -0,0 +1,74 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+// PCG32 (XSH-RR) generator. Every entity owns one, seeded from the run seed and
+// its own stream id, so a game replays bit-exactly from its seed.
+struct Rng {
+    uint64_t state;
+    uint64_t inc;   // stream selector, always odd
+};
+
+// Stream ids: entity kind in the high word, entity id in the low word
+#define RNG_STREAM_SETUP  0xFFFFFFFF00000000ULL
+#define RNG_STREAM_MAP    0xFFFFFFFE00000000ULL   // procedural house layouts
+#define RNG_STREAM_HUNTER(id) (0x0000000100000000ULL | (uint32_t)(id))
+#define RNG_STREAM_GHOST(id)  (0x0000000200000000ULL | (uint32_t)(id))
+
+/**
+ * @brief Seed a generator for one independent stream.
+ * @param[out] rng Generator to initialise.
+ * @param[in] seed Run seed shared by every entity of a game.
+ * @param[in] stream Stream id unique to the entity within the game.
+ */
+void rng_seed(struct Rng* rng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief Mix two values into a well-distributed 64-bit seed (SplitMix64).
+ * @param[in] a First input, e.g. a base seed.
+ * @param[in] b Second input, e.g. a run index.
+ * @return Derived seed.
+ */
+uint64_t rng_mix(uint64_t a, uint64_t b);
+
+/**
+ * @brief Next 32 uniformly distributed bits.
+ */
+static inline uint32_t rng_next(struct Rng* rng) {
+    uint64_t old = rng->state;
+    rng->state = old * 6364136223846793005ULL + rng->inc;
+    uint32_t xorshifted = (uint32_t)(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = (uint32_t)(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((-rot) & 31u));
+}
+
+/**
+ * @brief Unbiased integer in [0, bound) using Lemire's multiply-and-reject.
+ * @param[in,out] rng Generator.
+ * @param[in] bound Exclusive upper bound; 0 returns 0.
+ */
+static inline uint32_t rng_below(struct Rng* rng, uint32_t bound) {
+    if (bound == 0) return 0;
+    uint64_t product = (uint64_t)rng_next(rng) * bound;
+    uint32_t low = (uint32_t)product;
+    if (low < bound) {
+        uint32_t threshold = (uint32_t)(-bound) % bound;
+        while (low < threshold) {
+            product = (uint64_t)rng_next(rng) * bound;
+            low = (uint32_t)product;
+        }
+    }
+    return (uint32_t)(product >> 32);
+}
+
+/**
+ * @brief Unbiased integer in [lower_inclusive, upper_exclusive).
+ * @return lower_inclusive when the range is empty.
+ */
+static inline int rng_range(struct Rng* rng, int lower_inclusive, int upper_exclusive) {
+    if (upper_exclusive <= lower_inclusive) return lower_inclusive;
+    return lower_inclusive + (int)rng_below(rng, (uint32_t)(upper_exclusive - lower_inclusive));
+}
+
+#endif // RNG_H
@@ -1,28 +1,77 @@
 #include "roomstack.h"
 #include <stdlib.h>
+#include <string.h>
+
+#define STACK_INITIAL_CAPACITY 16
 
 void stack_init(struct RoomStack* stack) {
-    stack->top = NULL;
+    memset(stack, 0, sizeof(*stack));
+}
+
+void stack_set_limit(struct RoomStack* stack, int limit) {
+    stack_clear(stack);
+    if (limit > 0 && stack->capacity > limit) {
+        stack_free(stack); // a larger buffer would break the ring arithmetic
+    }
+    stack->limit = limit > 0 ? limit : 0;
+}
+
+// Move the rooms to a larger buffer, oldest first at slot 0
+static bool stack_grow(struct RoomStack* stack) {
+    int capacity = stack->capacity ? stack->capacity * 2 : STACK_INITIAL_CAPACITY;
+    if (stack->limit && capacity > stack->limit) capacity = stack->limit;
+
+    struct Room** slots = malloc((size_t)capacity * sizeof(*slots));
+    if (!slots) return false;
+    stack->buffers++;
+    int first = stack->capacity - stack->bottom; // rooms before the wrap point
+    if (first > stack->count) first = stack->count;
+    if (stack->count > 0) {
+        memcpy(slots, stack->slots + stack->bottom, (size_t)first * sizeof(*slots));
+        memcpy(slots + first, stack->slots, (size_t)(stack->count - first) * sizeof(*slots));
+    }
+    free(stack->slots);
+    stack->slots = slots;
+    stack->capacity = capacity;
+    stack->bottom = 0;
+    return true;
 }
 
 bool stack_push(struct RoomStack* stack, struct Room* room) {
-    struct RoomStackNode* node = malloc(sizeof(struct RoomStackNode));
-    if (!node) return false;
-    node->room = room;
-    node->next = stack->top;
-    stack->top = node;
+    if (stack->count == stack->capacity) {
+        if (stack->limit && stack->count == stack->limit) {
+            // Bounded and full: the new room replaces the oldest one
+            stack->slots[stack->bottom] = room;
+            stack->bottom = stack->bottom + 1 == stack->capacity ? 0 : stack->bottom + 1;
+            return true;
+        }
+        if (!stack_grow(stack)) return false;
+    }
+
+    int top = stack->bottom + stack->count;
+    if (top >= stack->capacity) top -= stack->capacity;
+    stack->slots[top] = room;
+    stack->count++;
     return true;
 }
 
 struct Room* stack_pop(struct RoomStack* stack) {
-    if (!stack->top) return NULL;
-    struct RoomStackNode* node = stack->top;
-    struct Room* r = node->room;
-    stack->top = node->next;
-    free(node);
-    return r;
+    if (stack->count == 0) return NULL;
+    stack->count--;
+    int top = stack->bottom + stack->count;
+    if (top >= stack->capacity) top -= stack->capacity;
+    return stack->slots[top];
 }
 
 void stack_clear(struct RoomStack* stack) {
-    while(stack_pop(stack));
+    stack->count = 0;
+    stack->bottom = 0;
+}
+
+void stack_free(struct RoomStack* stack) {
+    free(stack->slots);
+    stack->slots = NULL;
+    stack->capacity = 0;
+    stack->count = 0;
+    stack->bottom = 0;
 }
@@ -7,25 +7,36 @@
 struct Room;  // forward declaration
 
 
-struct RoomStackNode {
-    struct Room* room;
-    struct RoomStackNode* next;
-};
-
+// Rooms kept in one contiguous ring buffer. The buffer grows on demand and is
+// kept across stack_clear, so a reused stack stops allocating once it has
+// reached its working size. With a depth limit the stack becomes a bounded
+// ring: pushing onto a full stack forgets the oldest room.
+// A zero-initialised RoomStack is a valid empty, unbounded stack.
 struct RoomStack {
-    struct RoomStackNode* top;
+    struct Room** slots;  // ring buffer
+    int capacity;         // slots allocated
+    int count;            // rooms on the stack
+    int bottom;           // slot of the oldest room
+    int limit;            // maximum depth, 0 = unbounded
+    long buffers;         // slot buffers malloc'd so far, stack_free included
 };
 
-// Initialize an empty stack
+// Initialize an empty stack (unbounded, nothing allocated)
 void stack_init(struct RoomStack* stack);
 
-// Push a room onto the stack
+// Empty the stack and bound its depth (0 = unbounded); keeps the buffer when it fits
+void stack_set_limit(struct RoomStack* stack, int limit);
+
+// Push a room onto the stack (false only when growing the buffer fails)
 bool stack_push(struct RoomStack* stack, struct Room* room);
 
 // Pop a room from the stack
 struct Room* stack_pop(struct RoomStack* stack);
 
-// Clear the entire stack
+// Clear the entire stack in O(1), keeping the buffer for reuse
 void stack_clear(struct RoomStack* stack);
 
+// Release the buffer; the stack is empty and reusable afterwards
+void stack_free(struct RoomStack* stack);
+
 #endif // ROOMSTACK_H
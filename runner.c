@@ -0,0 +1,354 @@
+#include "runner.h"
+#include "helpers.h"
+#include "lockstep.h"
+#include "logger.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <time.h>
+
+#define RUNNER_CHUNK 64   // game indices claimed per atomic fetch
+
+// Per-worker state, padded so shards of neighbouring workers never share a cache line
+struct RunnerWorker {
+    const struct RunnerConfig* config;
+    atomic_long* next_run;
+    atomic_bool* failed;
+    pthread_t thread;
+    struct BatchStats shard;
+} __attribute__((aligned(64)));
+
+static double monotonic_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double percent(long part, long whole) {
+    return whole > 0 ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+int runner_default_workers(void) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    return cores > 0 ? (int)cores : 1;
+}
+
+// ---- Stats ----
+void batch_stats_add(struct BatchStats* stats, const struct SimResult* result) {
+    int ghost_index = ghost_type_index(result->ghost_type);
+    struct GhostTypeStats* ghost = &stats->by_ghost[ghost_index >= 0 ? ghost_index : 0];
+
+    stats->runs++;
+    ghost->runs++;
+    stats->total_duration_ms += result->duration_ms;
+    ghost->duration_ms_total += result->duration_ms;
+    stats->total_ticks += result->ticks;
+    stats->van_trips += result->van_trips;
+    stats->van_trip_ticks += result->van_trip_ticks;
+    stats->van_trips_abandoned += result->van_trips_abandoned;
+    if (result->ghost_caught) {
+        stats->wins++;
+        ghost->wins++;
+        ghost->solve_ms_total += result->duration_ms;
+        ghost->solve_ms_squares += (double)result->duration_ms * (double)result->duration_ms;
+    }
+    if (result->case_solved) stats->cases_solved++;
+    stats->tick_deadlines += result->tick_deadlines;
+    stats->tick_overruns += result->tick_overruns;
+    stats->ticks_missed += result->ticks_missed;
+    stats->tick_late_us += result->tick_late_us;
+    if (result->tick_late_us_max > stats->tick_late_us_max) stats->tick_late_us_max = result->tick_late_us_max;
+
+    for (int i = 0; i < 3; i++) {
+        stats->exit_counts[i] += result->exit_counts[i];
+        stats->hunter_exits += result->exit_counts[i];
+        ghost->exit_counts[i] += result->exit_counts[i];
+    }
+
+    int bits = 0;
+    for (int i = 0; i < 7; i++) {
+        if (result->total_evidence & (1 << i)) {
+            stats->evidence_type_counts[i]++;
+            bits++;
+        }
+    }
+    stats->evidence_bits_histogram[bits]++;
+}
+
+void batch_stats_merge(struct BatchStats* into, const struct BatchStats* from) {
+    into->runs += from->runs;
+    into->wins += from->wins;
+    into->hunter_exits += from->hunter_exits;
+    into->total_duration_ms += from->total_duration_ms;
+    into->total_ticks += from->total_ticks;
+    into->cases_solved += from->cases_solved;
+    into->arena_blocks += from->arena_blocks;
+    into->breadcrumb_buffers += from->breadcrumb_buffers;
+    into->log_allocations += from->log_allocations;
+    into->van_trips += from->van_trips;
+    into->van_trip_ticks += from->van_trip_ticks;
+    into->van_trips_abandoned += from->van_trips_abandoned;
+    into->tick_deadlines += from->tick_deadlines;
+    into->tick_overruns += from->tick_overruns;
+    into->ticks_missed += from->ticks_missed;
+    into->tick_late_us += from->tick_late_us;
+    if (from->tick_late_us_max > into->tick_late_us_max) into->tick_late_us_max = from->tick_late_us_max;
+    for (int i = 0; i < 3; i++) into->exit_counts[i] += from->exit_counts[i];
+    for (int i = 0; i < 8; i++) into->evidence_bits_histogram[i] += from->evidence_bits_histogram[i];
+    for (int i = 0; i < 7; i++) into->evidence_type_counts[i] += from->evidence_type_counts[i];
+
+    for (int g = 0; g < GHOST_TYPE_COUNT; g++) {
+        struct GhostTypeStats* dst = &into->by_ghost[g];
+        const struct GhostTypeStats* src = &from->by_ghost[g];
+        dst->runs += src->runs;
+        dst->wins += src->wins;
+        dst->solve_ms_total += src->solve_ms_total;
+        dst->solve_ms_squares += src->solve_ms_squares;
+        dst->duration_ms_total += src->duration_ms_total;
+        for (int i = 0; i < 3; i++) dst->exit_counts[i] += src->exit_counts[i];
+    }
+}
+
+void batch_stats_print(const struct BatchStats* stats, bool virtual_time) {
+    printf("Win rate: %ld/%ld (%.1f%%)\n", stats->wins, stats->runs, percent(stats->wins, stats->runs));
+    printf("Solved on the shared case file: %ld (%.1f%%)\n", stats->cases_solved, percent(stats->cases_solved, stats->runs));
+
+    printf("Hunter exit reasons:");
+    for (int i = 0; i < 3; i++) {
+        printf(" %s %ld (%.1f%%)%s",
+               exit_reason_to_string((enum LogReason)i),
+               stats->exit_counts[i],
+               percent(stats->exit_counts[i], stats->hunter_exits),
+               i < 2 ? "," : "\n");
+    }
+
+    printf("Distinct evidence types found per run:");
+    for (int bits = 0; bits <= 7; bits++) {
+        if (stats->evidence_bits_histogram[bits] == 0) continue;
+        printf(" %d: %ld (%.1f%%)", bits, stats->evidence_bits_histogram[bits],
+               percent(stats->evidence_bits_histogram[bits], stats->runs));
+    }
+    printf("\n");
+
+    printf("Runs finding each evidence type:");
+    const enum EvidenceType* evidence_types = NULL;
+    int evidence_count = get_all_evidence_types(&evidence_types);
+    for (int i = 0; i < evidence_count; i++) {
+        printf(" %s %.1f%%%s", evidence_to_string(evidence_types[i]),
+               percent(stats->evidence_type_counts[i], stats->runs),
+               i + 1 < evidence_count ? "," : "\n");
+    }
+
+    printf("Mean game length: %.1f s (%s time)\n",
+           stats->runs ? (double)stats->total_duration_ms / stats->runs / 1000.0 : 0.0,
+           virtual_time ? "virtual" : "wall");
+    printf("Returns to van: %ld arrived, %.2f moves per arrival, %ld abandoned (%.1f%%)\n",
+           stats->van_trips,
+           stats->van_trips ? (double)stats->van_trip_ticks / stats->van_trips : 0.0,
+           stats->van_trips_abandoned,
+           percent(stats->van_trips_abandoned, stats->van_trips + stats->van_trips_abandoned));
+    long allocations = stats->arena_blocks + stats->breadcrumb_buffers + stats->log_allocations;
+    printf("Allocations: %ld for %ld games (%.4f per game): %ld arena blocks, %ld breadcrumb buffers, %ld by the logger\n",
+           allocations, stats->runs, stats->runs ? (double)allocations / stats->runs : 0.0,
+           stats->arena_blocks, stats->breadcrumb_buffers, stats->log_allocations);
+    if (stats->tick_deadlines > 0) {
+        printf("Tick cadence: %ld deadlines, %ld overran (%.2f%%), %ld skipped, mean overrun %.1f ms, worst %.1f ms\n",
+               stats->tick_deadlines, stats->tick_overruns, percent(stats->tick_overruns, stats->tick_deadlines),
+               stats->ticks_missed,
+               stats->tick_overruns ? (double)stats->tick_late_us / stats->tick_overruns / 1000.0 : 0.0,
+               stats->tick_late_us_max / 1000.0);
+    }
+
+    printf("\n%-12s %8s %7s %10s %9s %7s %7s\n", "ghost", "runs", "win%", "solve(s)", "evidence", "bored", "afraid");
+    const enum GhostType* ghost_types = NULL;
+    int ghost_count = get_all_ghost_types(&ghost_types);
+    for (int g = 0; g < ghost_count; g++) {
+        const struct GhostTypeStats* ghost = &stats->by_ghost[g];
+        if (ghost->runs == 0) continue;
+        long exits = ghost->exit_counts[0] + ghost->exit_counts[1] + ghost->exit_counts[2];
+        printf("%-12s %8ld %6.1f%% %10.1f %8.1f%% %6.1f%% %6.1f%%\n",
+               ghost_to_string(ghost_types[g]),
+               ghost->runs,
+               percent(ghost->wins, ghost->runs),
+               ghost->wins ? (double)ghost->solve_ms_total / ghost->wins / 1000.0 : 0.0,
+               percent(ghost->exit_counts[LR_EVIDENCE], exits),
+               percent(ghost->exit_counts[LR_BORED], exits),
+               percent(ghost->exit_counts[LR_AFRAID], exits));
+    }
+}
+
+// ---- Workers ----
+// Game indices a worker has claimed but not started yet
+struct RunnerClaim {
+    struct RunnerWorker* worker;
+    long next;
+    long end;
+};
+
+static bool runner_claim_next(void* context, uint64_t* run_seed) {
+    struct RunnerClaim* claim = context;
+    struct RunnerWorker* worker = claim->worker;
+    const struct RunnerConfig* config = worker->config;
+    if (claim->next == claim->end) {
+        long begin = atomic_fetch_add_explicit(worker->next_run, RUNNER_CHUNK, memory_order_relaxed);
+        if (begin >= config->runs || atomic_load_explicit(worker->failed, memory_order_relaxed)) return false;
+        claim->next = begin;
+        claim->end = begin + RUNNER_CHUNK < config->runs ? begin + RUNNER_CHUNK : config->runs;
+    }
+    *run_seed = sim_run_seed(config->seed, config->first_run + (uint64_t)claim->next++);
+    return true;
+}
+
+static void runner_record(void* context, const struct SimResult* result) {
+    struct RunnerClaim* claim = context;
+    batch_stats_add(&claim->worker->shard, result);
+}
+
+// Play the worker's games side by side in lockstep lanes
+static bool runner_lockstep(struct RunnerWorker* worker, struct House* house, struct Hunter* hunters,
+                            struct Ghost* ghosts, int ghost_count, struct Arena* arena) {
+    const struct RunnerConfig* config = worker->config;
+    int lanes = config->lanes > 0 ? config->lanes : LOCKSTEP_DEFAULT_LANES;
+    if (house->room_count > LOCKSTEP_MAX_ROOMS) {
+        fprintf(stderr, "Lockstep needs a house of at most %d rooms\n", LOCKSTEP_MAX_ROOMS);
+        return false;
+    }
+    struct Lockstep* ls = arena_alloc(arena, sizeof(*ls), CACHE_LINE_SIZE);
+    if (!ls || !lockstep_init(ls, house, lanes, hunters, config->hunter_count, ghosts, ghost_count, arena)) {
+        fprintf(stderr, "Lockstep: out of memory setting up %d lanes\n", lanes);
+        return false;
+    }
+
+    struct RunnerClaim claim = { worker, 0, 0 };
+    struct LockstepFeed feed = { runner_claim_next, runner_record, &claim };
+    lockstep_run(ls, &feed);
+    return true;
+}
+
+static void* runner_worker_fn(void* arg) {
+    struct RunnerWorker* worker = (struct RunnerWorker*)arg;
+    const struct RunnerConfig* config = worker->config;
+
+    // Every worker owns a complete game: house, ghost and hunters
+    int ghost_count = config->ghost_count > 0 ? config->ghost_count : 1;
+    struct House house;
+    if (!house_init(&house, config->map)) {
+        atomic_store(worker->failed, true);
+        return NULL;
+    }
+    house_set_room_capacity(&house, config->room_capacity);
+    house.random_return = config->random_return;
+    house.private_evidence = config->private_evidence;
+    house.reactive = config->reactive;
+    house.pool_workers = config->pool_workers;
+
+    // Entities live as long as the worker; everything a single game allocates
+    // comes from the game arena, which house_reset rewinds between games
+    struct Arena entities;
+    struct Arena game;
+    arena_init(&entities, 0);
+    arena_init(&game, 0);
+    house.arena = &game;
+    size_t hunter_bytes = (size_t)config->hunter_count * sizeof(struct Hunter);
+    size_t ghost_bytes = (size_t)ghost_count * sizeof(struct Ghost);
+    struct Hunter* hunters = arena_alloc(&entities, hunter_bytes, _Alignof(struct Hunter));
+    struct Ghost* ghosts = arena_alloc(&entities, ghost_bytes, _Alignof(struct Ghost));
+    if (!hunters || !ghosts) {
+        atomic_store(worker->failed, true);
+        arena_free(&entities);
+        house_cleanup(&house);
+        return NULL;
+    }
+    memset(hunters, 0, hunter_bytes);
+    memset(ghosts, 0, ghost_bytes);
+    for (int i = 0; i < config->hunter_count; i++) {
+        hunters[i].id = config->roster[i].id;
+        memcpy(hunters[i].name, config->roster[i].name, sizeof(hunters[i].name));
+    }
+
+    // Lockstep play drains the shared counter, so the loop below finds nothing left
+    if (config->engine == SIM_ENGINE_LOCKSTEP && !runner_lockstep(worker, &house, hunters, ghosts, ghost_count,
+                                                                  &entities)) {
+        atomic_store(worker->failed, true);
+    }
+
+    bool first_game = true;
+    for (;;) {
+        long begin = atomic_fetch_add_explicit(worker->next_run, RUNNER_CHUNK, memory_order_relaxed);
+        if (begin >= config->runs || atomic_load_explicit(worker->failed, memory_order_relaxed)) break;
+        long end = begin + RUNNER_CHUNK < config->runs ? begin + RUNNER_CHUNK : config->runs;
+
+        for (long run = begin; run < end; run++) {
+            if (!first_game) house_reset(&house);
+            first_game = false;
+
+            uint64_t run_seed = sim_run_seed(config->seed, config->first_run + (uint64_t)run);
+            house.log_run = (long long)(config->first_run + (uint64_t)run);
+            sim_setup_ghosts(&house, ghosts, ghost_count, run_seed);
+            for (int i = 0; i < config->hunter_count; i++) {
+                sim_setup_hunter(&house, &hunters[i], run_seed);
+            }
+
+            struct SimResult result;
+            if (!sim_run(config->engine, &house, ghosts, ghost_count, hunters, config->hunter_count, &result)) {
+                atomic_store(worker->failed, true);
+                break;
+            }
+            batch_stats_add(&worker->shard, &result);
+        }
+    }
+
+    for (int i = 0; i < config->hunter_count; i++) {
+        worker->shard.breadcrumb_buffers += hunters[i].breadcrumb.buffers;
+        stack_free(&hunters[i].breadcrumb);
+    }
+    worker->shard.arena_blocks += entities.blocks + game.blocks;
+    arena_free(&entities);
+    arena_free(&game);
+    house_cleanup(&house);
+    return NULL;
+}
+
+bool runner_run(const struct RunnerConfig* config, struct BatchStats* stats, double* seconds) {
+    int worker_count = config->workers > 0 ? config->workers : runner_default_workers();
+    struct RunnerWorker* workers = aligned_alloc(64, (size_t)worker_count * sizeof(*workers));
+    if (!workers) return false;
+    memset(workers, 0, (size_t)worker_count * sizeof(*workers));
+
+    atomic_long next_run = 0;
+    atomic_bool failed = false;
+    long log_allocations = logger_allocations();
+    double started = monotonic_seconds();
+
+    int started_workers = 0;
+    for (int w = 0; w < worker_count; w++) {
+        workers[w].config = config;
+        workers[w].next_run = &next_run;
+        workers[w].failed = &failed;
+        if (worker_count == 1) {
+            runner_worker_fn(&workers[w]); // no point paying for a thread
+            started_workers = 1;
+            break;
+        }
+        if (pthread_create(&workers[w].thread, NULL, runner_worker_fn, &workers[w]) != 0) {
+            perror("Failed to create worker thread");
+            atomic_store(&failed, true);
+            break;
+        }
+        started_workers++;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    for (int w = 0; w < started_workers; w++) {
+        if (worker_count > 1) pthread_join(workers[w].thread, NULL);
+        batch_stats_merge(stats, &workers[w].shard);
+    }
+    stats->log_allocations = logger_allocations() - log_allocations;
+
+    *seconds = monotonic_seconds() - started;
+    free(workers);
+    return !atomic_load(&failed);
+}
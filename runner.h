@@ -0,0 +1,101 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include "sim.h"
+#include <stdint.h>
+
+#define GHOST_TYPE_COUNT 24   // entries returned by get_all_ghost_types
+
+// Outcomes for one ghost type
+struct GhostTypeStats {
+    long runs;
+    long wins;
+    long long solve_ms_total;   // summed game length of the games that were won
+    double solve_ms_squares;    // summed squares of those lengths, for their variance
+    long long duration_ms_total; // summed game length of every game
+    long exit_counts[3];        // hunter exits, indexed by enum LogReason
+};
+
+// Totals across many games; shards from different workers merge by addition
+struct BatchStats {
+    long runs;
+    long wins;
+    long exit_counts[3];
+    long hunter_exits;
+    long long total_duration_ms;
+    long total_ticks;
+    long cases_solved;                // runs the shared case file solved
+    long arena_blocks;                // mallocs made by the workers' arenas, all games included
+    long breadcrumb_buffers;          // mallocs made by the hunters' breadcrumb stacks
+    long log_allocations;             // mallocs made by the logger while the batch ran
+    long van_trips;                   // hunter returns to the van that arrived
+    long van_trip_ticks;
+    long van_trips_abandoned;
+    long tick_deadlines;              // entity tick cadence, threads engine only
+    long tick_overruns;
+    long ticks_missed;
+    long long tick_late_us;
+    long long tick_late_us_max;
+    long evidence_bits_histogram[8];  // runs by number of distinct evidence bits found
+    long evidence_type_counts[7];     // runs in which each evidence type was found
+    struct GhostTypeStats by_ghost[GHOST_TYPE_COUNT];
+};
+
+// What a batch should run
+struct RunnerConfig {
+    int workers;                  // worker threads, each with its own House
+    long runs;
+    uint64_t seed;                // game k uses sim_run_seed(seed, first_run + k)
+    uint64_t first_run;
+    enum SimEngine engine;
+    const struct Hunter* roster;  // ids and names copied into every worker
+    int hunter_count;
+    int ghost_count;              // ghosts per game (0 is treated as 1)
+    int room_capacity;            // hunters per room, 0 = unlimited
+    const struct HouseMap* map;   // layout shared by every worker, NULL = Willow
+    bool random_return;           // returning hunters wander instead of following exit routes
+    bool private_evidence;        // hunters do not share evidence through the case file
+    bool reactive;                // threads engine: wake entities on room signals, not just ticks
+    int pool_workers;             // pool engine: threads per game, 0 = one per core
+    int lanes;                    // lockstep engine: games per lane batch, 0 = LOCKSTEP_DEFAULT_LANES
+};
+
+/**
+ * @brief Number of online cores, at least 1.
+ */
+int runner_default_workers(void);
+
+/**
+ * @brief Add one game to a stats shard.
+ * @param[in,out] stats Shard to update.
+ * @param[in] result Game outcome.
+ */
+void batch_stats_add(struct BatchStats* stats, const struct SimResult* result);
+
+/**
+ * @brief Add every counter of one shard into another.
+ * @param[in,out] into Destination totals.
+ * @param[in] from Shard to merge.
+ */
+void batch_stats_merge(struct BatchStats* into, const struct BatchStats* from);
+
+/**
+ * @brief Print the batch summary and the per-ghost-type table.
+ * @param[in] stats Merged totals.
+ * @param[in] virtual_time true when game lengths are virtual-clock times.
+ */
+void batch_stats_print(const struct BatchStats* stats, bool virtual_time);
+
+/**
+ * @brief Play config->runs games on a pool of worker threads. Workers claim
+ *        game indices in chunks from a shared atomic counter and record into
+ *        private shards that are merged once all workers finish. Results do not
+ *        depend on the worker count.
+ * @param[in] config Batch description.
+ * @param[out] stats Merged totals.
+ * @param[out] seconds Wall-clock time spent playing.
+ * @return false when a worker could not be started or a game failed.
+ */
+bool runner_run(const struct RunnerConfig* config, struct BatchStats* stats, double* seconds);
+
+#endif // RUNNER_H
@@ -0,0 +1,178 @@
+#include "sim.h"
+#include "helpers.h"
+#include "logger.h"
+#include "engine.h"
+#include "pool.h"
+#include "simclock.h"
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+
+bool sim_parse_engine(const char* name, enum SimEngine* engine) {
+    if (!name || !engine) return false;
+    if (strcmp(name, "threads") == 0) {
+        *engine = SIM_ENGINE_THREADS;
+        return true;
+    }
+    if (strcmp(name, "events") == 0) {
+        *engine = SIM_ENGINE_EVENTS;
+        return true;
+    }
+    if (strcmp(name, "pool") == 0) {
+        *engine = SIM_ENGINE_POOL;
+        return true;
+    }
+    if (strcmp(name, "lockstep") == 0) {
+        *engine = SIM_ENGINE_LOCKSTEP;
+        return true;
+    }
+    return false;
+}
+
+uint64_t sim_run_seed(uint64_t base_seed, uint64_t run_index) {
+    return rng_mix(base_seed, run_index);
+}
+
+void sim_setup_ghosts(struct House* house, struct Ghost* ghosts, int ghost_count, uint64_t run_seed) {
+    const enum GhostType* ghost_types = NULL;
+    int g_count = get_all_ghost_types(&ghost_types);
+
+    // Game setup draws from its own stream so entity streams stay independent
+    struct Rng setup;
+    rng_seed(&setup, run_seed, RNG_STREAM_SETUP);
+    enum GhostType type = ghost_types[rng_range(&setup, 0, g_count)];
+
+    for (int i = 0; i < ghost_count; i++) {
+        struct Ghost* ghost = &ghosts[i];
+        ghost->id = DEFAULT_GHOST_ID + i;
+        ghost->type = type;
+        ghost->current_room = &house->rooms[rng_range(&setup, 0, house->room_count)];
+        atomic_store(&ghost->running, true);
+        memset(&ghost->schedule, 0, sizeof(ghost->schedule));
+        rng_seed(&ghost->rng, run_seed, RNG_STREAM_GHOST(ghost->id));
+    }
+}
+
+void sim_setup_hunter(struct House* house, struct Hunter* hunter, uint64_t run_seed) {
+    hunter->current_room = house->starting_room;
+    hunter->boredom = 0;
+    hunter->fear = 0;
+    hunter->collected = 0;
+    hunter->exit_reason = LR_BORED;
+    hunter->room_slot = -1;
+    atomic_store(&hunter->running, true);
+    memset(&hunter->schedule, 0, sizeof(hunter->schedule));
+    rng_seed(&hunter->rng, run_seed, RNG_STREAM_HUNTER(hunter->id));
+}
+
+// Fold one entity's tick cadence into the game totals
+static void add_schedule(struct SimResult* result, const struct TickSchedule* schedule) {
+    result->tick_deadlines += schedule->deadlines;
+    result->tick_overruns += schedule->overruns;
+    result->ticks_missed += schedule->missed;
+    result->tick_late_us += schedule->late_us;
+    if (schedule->late_us_max > result->tick_late_us_max) result->tick_late_us_max = schedule->late_us_max;
+}
+
+static void summarise(struct House* house, const struct Ghost* ghosts, int ghost_count, const struct Hunter* hunters,
+                      int hunter_count, struct SimResult* result) {
+    const struct Ghost* ghost = &ghosts[0];
+    memset(result, 0, sizeof(*result));
+    result->ghost_type = ghost->type;
+    result->case_solved = casefile_is_solved(&house->casefile);
+    result->hunter_count = hunter_count;
+
+    for (int i = 0; i < hunter_count; i++) {
+        result->total_evidence |= hunters[i].collected;
+        result->exit_counts[hunters[i].exit_reason]++;
+        result->van_trips += hunters[i].van_trips;
+        result->van_trip_ticks += hunters[i].van_trip_ticks;
+        result->van_trips_abandoned += hunters[i].van_trips_abandoned;
+        add_schedule(result, &hunters[i].schedule);
+        if (hunters[i].exit_reason == LR_EVIDENCE) {
+            result->ghost_caught = true;
+        }
+    }
+
+    for (int i = 0; i < ghost_count; i++) {
+        add_schedule(result, &ghosts[i].schedule);
+    }
+
+    if ((result->total_evidence & (EvidenceByte)ghost->type) == ghost->type) {
+        result->ghost_caught = true;
+    }
+}
+
+// Clear every ghost's running flag and wake any that are mid-sleep
+static void stop_ghosts(struct House* house, struct Ghost* ghosts, int ghost_count) {
+    for (int i = 0; i < ghost_count; i++) {
+        atomic_store(&ghosts[i].running, false);
+    }
+    house_wake_all(house);
+}
+
+static bool run_threads(struct House* house, struct Ghost* ghosts, int ghost_count, struct Hunter* hunters, int hunter_count,
+                        long long* duration_ms) {
+    long long start_ms = simclock_wall_ms();
+
+    // Start ghost threads first
+    for (int i = 0; i < ghost_count; i++) {
+        if (pthread_create(&ghosts[i].thread, NULL, ghost_thread_fn, &ghosts[i]) != 0) {
+            perror("Failed to create ghost thread");
+            stop_ghosts(house, ghosts, i);
+            for (int j = 0; j < i; j++) {
+                pthread_join(ghosts[j].thread, NULL);
+            }
+            return false;
+        }
+    }
+
+    // Start ALL hunter threads at once (they will run concurrently with each other and the ghost)
+    for (int i = 0; i < hunter_count; i++) {
+        if (pthread_create(&hunters[i].thread, NULL, hunter_thread_fn, &hunters[i]) != 0) {
+            perror("Failed to create hunter thread");
+            // Only join the threads that were actually created
+            hunter_count = i;
+            break;
+        }
+    }
+
+    // Wait for ALL hunter threads to finish
+    for (int i = 0; i < hunter_count; i++) {
+        pthread_join(hunters[i].thread, NULL);
+    }
+    *duration_ms = simclock_wall_ms() - start_ms;
+
+    // After all hunters finish, stop the ghosts and join them; the wake-up means
+    // this takes microseconds rather than the rest of a ghost tick
+    stop_ghosts(house, ghosts, ghost_count);
+    for (int i = 0; i < ghost_count; i++) {
+        pthread_join(ghosts[i].thread, NULL);
+    }
+    return true;
+}
+
+bool sim_run(enum SimEngine engine, struct House* house, struct Ghost* ghosts, int ghost_count,
+             struct Hunter* hunters, int hunter_count, struct SimResult* result) {
+    long long duration_ms = 0;
+    long ticks = 0;
+    bool started = false;
+    logger_set_run(house->log_run);
+    if (engine == SIM_ENGINE_EVENTS || engine == SIM_ENGINE_LOCKSTEP) {
+        started = engine_run(ghosts, ghost_count, hunters, hunter_count, &duration_ms, &ticks, house->arena);
+    } else if (engine == SIM_ENGINE_POOL) {
+        struct PoolReport report;
+        started = pool_run(house, ghosts, ghost_count, hunters, hunter_count, house->pool_workers, &report);
+        duration_ms = report.duration_ms;
+        ticks = report.ticks;
+    } else {
+        started = run_threads(house, ghosts, ghost_count, hunters, hunter_count, &duration_ms);
+    }
+    logger_end_run(house->log_run);
+    if (!started) return false;
+
+    summarise(house, ghosts, ghost_count, hunters, hunter_count, result);
+    result->duration_ms = duration_ms;
+    result->ticks = ticks;
+    return true;
+}
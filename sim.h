@@ -0,0 +1,88 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include "defs.h"
+
+// How a game is executed
+enum SimEngine {
+    SIM_ENGINE_THREADS = 0,  // one pthread per entity, real-time usleep pacing
+    SIM_ENGINE_EVENTS = 1,   // single-threaded discrete events on a virtual clock
+    SIM_ENGINE_POOL = 2,     // real-time pacing, entities multiplexed over a worker pool
+    SIM_ENGINE_LOCKSTEP = 3  // batches only: event-engine games played side by side in SIMD lanes
+};
+
+// Outcome of one simulated game
+struct SimResult {
+    enum GhostType ghost_type;
+    bool ghost_caught;
+    bool case_solved;              // the shared case file named the ghost
+    EvidenceByte total_evidence;   // union of every hunter's collected mask
+    int hunter_count;
+    int exit_counts[3];            // indexed by enum LogReason
+    long long duration_ms;         // until the last hunter exits (virtual time in event mode)
+    long ticks;                    // entity ticks executed (event and pool modes)
+    int van_trips;                 // returns to the van that arrived, summed over hunters
+    int van_trip_ticks;            // moves spent returning, abandoned returns included
+    int van_trips_abandoned;       // returns cut short by a hunter leaving
+    long tick_deadlines;           // tick deadlines reached by every entity (threads engine only)
+    long tick_overruns;            // ticks whose work ran past the next deadline
+    long ticks_missed;             // deadlines skipped to recover from overruns
+    long long tick_late_us;        // summed lateness of overrunning ticks
+    long long tick_late_us_max;    // worst single overrun
+};
+
+/**
+ * @brief Parse an engine name ("threads", "events", "pool" or "lockstep").
+ * @param[in] name Engine text.
+ * @param[out] engine Parsed value.
+ * @return true when the name is recognised.
+ */
+bool sim_parse_engine(const char* name, enum SimEngine* engine);
+
+/**
+ * @brief Derive the seed of one game from a base seed and the game's index.
+ * @param[in] base_seed Seed given for the whole batch.
+ * @param[in] run_index Zero-based game number.
+ * @return Seed passed to sim_setup_ghost/sim_setup_hunter for that game.
+ */
+uint64_t sim_run_seed(uint64_t base_seed, uint64_t run_index);
+
+/**
+ * @brief Pick the ghost type and starting rooms for a new game and seed each
+ *        ghost's own random stream. All ghosts of a game share one type (a
+ *        single haunting with several manifestations), so the evidence rules
+ *        and win condition are unchanged; ids are DEFAULT_GHOST_ID + index.
+ * @param[in] house Populated house.
+ * @param[out] ghosts Ghosts to initialise (id, type, room, running flag, rng).
+ * @param[in] ghost_count Number of ghosts, at least 1.
+ * @param[in] run_seed Seed of this game.
+ */
+void sim_setup_ghosts(struct House* house, struct Ghost* ghosts, int ghost_count, uint64_t run_seed);
+
+/**
+ * @brief Reset a hunter for a new game while keeping its id and name, and seed
+ *        its random stream from the run seed and its id.
+ * @param[in] house Populated house; hunters start in its starting room.
+ * @param[in,out] hunter Hunter to reset.
+ * @param[in] run_seed Seed of this game.
+ */
+void sim_setup_hunter(struct House* house, struct Hunter* hunter, uint64_t run_seed);
+
+/**
+ * @brief Run one game and summarise the outcome. The house must be freshly
+ *        populated or reset.
+ * @param[in] engine Threaded real-time or virtual-clock event execution. A
+ *            single lockstep game runs on the event engine, which plays it
+ *            identically.
+ * @param[in,out] house House the game runs in.
+ * @param[in,out] ghosts Ghosts prepared with sim_setup_ghosts.
+ * @param[in] ghost_count Number of ghosts.
+ * @param[in,out] hunters Hunters prepared with sim_setup_hunter.
+ * @param[in] hunter_count Number of hunters.
+ * @param[out] result Game outcome.
+ * @return false when the game could not be started.
+ */
+bool sim_run(enum SimEngine engine, struct House* house, struct Ghost* ghosts, int ghost_count,
+             struct Hunter* hunters, int hunter_count, struct SimResult* result);
+
+#endif // SIM_H
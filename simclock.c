@@ -0,0 +1,107 @@
+#include "simclock.h"
+#include <errno.h>
+#include <stddef.h>
+#include <sys/time.h>
+#include <time.h>
+
+static _Thread_local const long long* virtual_now = NULL;
+
+long long simclock_wall_ms(void) {
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (long long)tv.tv_sec * 1000LL + (long long)tv.tv_usec / 1000LL;
+}
+
+long long simclock_now_ms(void) {
+    return virtual_now ? *virtual_now : simclock_wall_ms();
+}
+
+void simclock_use_virtual(const long long* now_ms) {
+    virtual_now = now_ms;
+}
+
+// ---- Interruptible sleep ----
+static void timespec_add_ns(struct timespec* ts, long long ns) {
+    ns += ts->tv_nsec;
+    ts->tv_sec += (time_t)(ns / 1000000000LL);
+    ts->tv_nsec = (long)(ns % 1000000000LL);
+}
+
+static long long timespec_diff_ns(const struct timespec* a, const struct timespec* b) {
+    return (long long)(a->tv_sec - b->tv_sec) * 1000000000LL + (a->tv_nsec - b->tv_nsec);
+}
+
+bool simclock_waker_init(struct SimWaker* waker) {
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0) return false;
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC); // immune to wall-clock steps
+    bool ok = pthread_cond_init(&waker->cond, &attr) == 0;
+    pthread_condattr_destroy(&attr);
+    if (!ok) return false;
+    if (pthread_mutex_init(&waker->lock, NULL) != 0) {
+        pthread_cond_destroy(&waker->cond);
+        return false;
+    }
+    waker->generation = 0;
+    return true;
+}
+
+void simclock_waker_destroy(struct SimWaker* waker) {
+    pthread_cond_destroy(&waker->cond);
+    pthread_mutex_destroy(&waker->lock);
+}
+
+bool simclock_sleep_until(struct SimWaker* waker, const struct timespec* deadline, const atomic_bool* running) {
+    // The flag is checked under the lock, and stoppers bump the generation
+    // under the same lock after clearing it, so a stop cannot slip in between
+    pthread_mutex_lock(&waker->lock);
+    unsigned long generation = waker->generation;
+    int rc = 0;
+    while (rc != ETIMEDOUT && waker->generation == generation && atomic_load(running)) {
+        rc = pthread_cond_timedwait(&waker->cond, &waker->lock, deadline);
+    }
+    pthread_mutex_unlock(&waker->lock);
+    return atomic_load(running);
+}
+
+void simclock_wake_all(struct SimWaker* waker) {
+    pthread_mutex_lock(&waker->lock);
+    waker->generation++;
+    pthread_cond_broadcast(&waker->cond);
+    pthread_mutex_unlock(&waker->lock);
+}
+
+// ---- Tick schedule ----
+void simclock_schedule_start(struct TickSchedule* schedule, long period_ms) {
+    clock_gettime(CLOCK_MONOTONIC, &schedule->next); // the first tick is due now
+    schedule->period_ms = period_ms;
+    schedule->deadlines = 0;
+    schedule->overruns = 0;
+    schedule->missed = 0;
+    schedule->late_us = 0;
+    schedule->late_us_max = 0;
+}
+
+void simclock_schedule_next(struct TickSchedule* schedule, struct timespec* deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long period_ns = schedule->period_ms * 1000000LL;
+
+    if (timespec_diff_ns(&now, &schedule->next) >= 0) {
+        // The tick that just ran was due at schedule->next; the one after is a period later
+        schedule->deadlines++;
+        timespec_add_ns(&schedule->next, period_ns);
+
+        long long late_ns = timespec_diff_ns(&now, &schedule->next);
+        if (late_ns >= 0) {
+            long long late_us = late_ns / 1000;
+            long long skipped = late_ns / period_ns + 1;
+            schedule->overruns++;
+            schedule->missed += (long)skipped;
+            schedule->late_us += late_us;
+            if (late_us > schedule->late_us_max) schedule->late_us_max = late_us;
+            timespec_add_ns(&schedule->next, skipped * period_ns);
+        }
+    }
+    *deadline = schedule->next;
+}
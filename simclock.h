@@ -0,0 +1,103 @@
+#ifndef SIMCLOCK_H
+#define SIMCLOCK_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <time.h>
+
+// Time source for log timestamps. Threads normally read the wall clock; a thread
+// running the event engine installs a virtual clock it advances itself.
+//
+// Entity threads pace themselves with simclock_sleep_until on their house's
+// waker, so a stop request or a solved case wakes them at once instead of
+// waiting out the rest of a 200-300 ms tick.
+//
+// Tick deadlines are absolute: a TickSchedule places tick k at start + k *
+// period on CLOCK_MONOTONIC, so time spent working (logging, lock waits) does
+// not stretch the period. A tick whose work runs past the next deadline is an
+// overrun; the schedule then skips ahead to the next deadline still in the
+// future, keeping the original phase, and counts what it skipped.
+
+struct SimWaker {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;          // waits on CLOCK_MONOTONIC
+    unsigned long generation;     // bumped by every simclock_wake_all, guarded by lock
+};
+
+struct TickSchedule {
+    struct timespec next;         // upcoming deadline on CLOCK_MONOTONIC
+    long period_ms;
+    long deadlines;               // deadlines reached so far
+    long overruns;                // ticks whose work ran past the following deadline
+    long missed;                  // deadlines skipped after overruns
+    long long late_us;            // summed lateness of overrunning ticks
+    long long late_us_max;        // worst lateness of a single tick
+};
+
+/**
+ * @brief Current wall-clock time in milliseconds since the epoch.
+ */
+long long simclock_wall_ms(void);
+
+/**
+ * @brief Current time for the calling thread: the virtual clock if one is
+ *        installed, otherwise the wall clock.
+ */
+long long simclock_now_ms(void);
+
+/**
+ * @brief Install (or with NULL remove) a virtual clock for the calling thread.
+ * @param[in] now_ms Clock value owned by the caller, read on every call.
+ */
+void simclock_use_virtual(const long long* now_ms);
+
+/**
+ * @brief Prepare a waker.
+ * @param[out] waker Waker to initialise.
+ * @return false when the lock or condition variable could not be created.
+ */
+bool simclock_waker_init(struct SimWaker* waker);
+
+/**
+ * @brief Destroy a waker nobody is sleeping on.
+ * @param[in,out] waker Waker to destroy.
+ */
+void simclock_waker_destroy(struct SimWaker* waker);
+
+/**
+ * @brief Start a schedule whose first tick is now.
+ * @param[out] schedule Schedule to reset.
+ * @param[in] period_ms Tick period.
+ */
+void simclock_schedule_start(struct TickSchedule* schedule, long period_ms);
+
+/**
+ * @brief Call after each tick: account for the deadline just reached (and any
+ *        overrun) and return the absolute deadline to sleep until. Calling
+ *        again before that deadline, e.g. after an early wake-up, returns the
+ *        same deadline.
+ * @param[in,out] schedule Entity's schedule.
+ * @param[out] deadline When the next tick is due.
+ */
+void simclock_schedule_next(struct TickSchedule* schedule, struct timespec* deadline);
+
+/**
+ * @brief Sleep until an absolute CLOCK_MONOTONIC deadline. Returns early when
+ *        another thread calls simclock_wake_all, or at once when *running is
+ *        already false. Clearing *running and then calling simclock_wake_all
+ *        can never be missed.
+ * @param[in] waker Waker shared by the sleeping entities.
+ * @param[in] deadline When to wake at the latest.
+ * @param[in] running The caller's stop flag.
+ * @return The final value of *running.
+ */
+bool simclock_sleep_until(struct SimWaker* waker, const struct timespec* deadline, const atomic_bool* running);
+
+/**
+ * @brief Wake every thread sleeping on the waker.
+ * @param[in,out] waker Waker to signal.
+ */
+void simclock_wake_all(struct SimWaker* waker);
+
+#endif // SIMCLOCK_H